@@ -0,0 +1,107 @@
+/*
+  Interrupt-driven continuous sampling over SPI from the MMC5983MA
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example demonstrates how to use SFE_MMC5983MA_Sampler to collect continuous mode samples at 1000Hz
+  without losing any when loop() is held up.
+  The INT pin ISR reads each frame and pushes it into a lock-free ring buffer.
+  loop() drains the ring in batches. Overruns, missed interrupts and the high-water mark are reported
+  so you can tell if the ring is too small.
+
+  If your platform cannot use SPI from an interrupt, call sampler.onInterrupt() from the ISR
+  and sampler.service() from loop() (or a task) instead.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS to pin 4 on an Arduino.
+  Connect INT to pin 2 on an Arduino.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Sampler.h>
+
+SFE_MMC5983MA myMag;
+
+// The ring capacity must be a power of two
+SFE_MMC5983MA_Sampler<64> sampler(myMag);
+
+int csPin = 4;
+
+int interruptPin = 2;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    while (myMag.begin(csPin) == false)
+    {
+        Serial.println("MMC5983MA did not respond. Retrying...");
+        delay(500);
+        myMag.softReset();
+        delay(500);
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    // 1000Hz continuous mode needs the 800Hz filter bandwidth
+    myMag.setFilterBandwidth(800);
+    myMag.setContinuousModeFrequency(1000);
+    myMag.enableAutomaticSetReset();
+    myMag.enableInterrupt();
+
+    // The ISR uses SPI, so tell the SPI library to protect its transactions from it
+    pinMode(interruptPin, INPUT);
+    SPI.usingInterrupt(digitalPinToInterrupt(interruptPin));
+    attachInterrupt(digitalPinToInterrupt(interruptPin), interruptRoutine, RISING);
+
+    myMag.enableContinuousMode();
+}
+
+void loop()
+{
+    static unsigned long lastReport = millis();
+    static unsigned long framesThisSecond = 0;
+
+    // Drain the ring in batches
+    SFE_MMC5983MA_Frame frames[16];
+    uint8_t count = sampler.drain(frames, 16);
+    framesThisSecond += count;
+
+    // Process the frames here. The most recent one is printed once per second below.
+
+    if ((count > 0) && (millis() - lastReport >= 1000))
+    {
+        Serial.print("Frames/s: ");
+        Serial.print(framesThisSecond);
+        Serial.print("\tX: ");
+        Serial.print(frames[count - 1].x);
+        Serial.print("\tY: ");
+        Serial.print(frames[count - 1].y);
+        Serial.print("\tZ: ");
+        Serial.print(frames[count - 1].z);
+        Serial.print("\tOverruns: ");
+        Serial.print(sampler.getOverruns());
+        Serial.print("\tHigh-water mark: ");
+        Serial.println(sampler.getHighWaterMark());
+
+        framesThisSecond = 0;
+        lastReport = millis();
+    }
+}
+
+void interruptRoutine()
+{
+    sampler.sample();
+}
@@ -0,0 +1,105 @@
+/*
+  Measuring I2C read transaction time with and without repeated START
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  By default each register read writes the register address, sends a STOP, then a new START
+  and reads the data. With setI2CRepeatedStart(true) the STOP/START pair is replaced by a
+  repeated START, which saves time and a bus arbitration on every read - including every
+  status poll while waiting for a measurement.
+
+  This example times readFieldsXYZ and readFrame at 100kHz and 400kHz (the fastest I2C clock
+  supported by the MMC5983MA) in both modes.
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper
+  (https://www.sparkfun.com/products/17912) Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+
+SFE_MMC5983MA myMag;
+
+const uint32_t clocks[] = {100000, 400000};
+const uint16_t iterations = 500;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    Wire.begin();
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+}
+
+// Returns the mean time in microseconds for one readFieldsXYZ
+unsigned long timeReadFields()
+{
+    uint32_t x, y, z;
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < iterations; i++)
+        myMag.readFieldsXYZ(&x, &y, &z);
+    return (micros() - start) / iterations;
+}
+
+// Returns the mean time in microseconds for one readFrame
+unsigned long timeReadFrame()
+{
+    SFE_MMC5983MA_Frame frame;
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < iterations; i++)
+        myMag.readFrame(&frame, 0); // Don't clear the done bits, so each readFrame is a single transaction
+    return (micros() - start) / iterations;
+}
+
+void printResults(const char *mode)
+{
+    Serial.print(mode);
+    Serial.print("\t");
+    Serial.print(timeReadFields());
+    Serial.print("\t\t\t");
+    Serial.println(timeReadFrame());
+}
+
+void loop()
+{
+    for (uint8_t i = 0; i < sizeof(clocks) / sizeof(clocks[0]); i++)
+    {
+        Wire.setClock(clocks[i]);
+
+        Serial.println();
+        Serial.print("I2C clock: ");
+        Serial.print(clocks[i] / 1000);
+        Serial.println("kHz");
+        Serial.println("Mode\t\t\treadFieldsXYZ (us)\treadFrame (us)");
+
+        myMag.setI2CRepeatedStart(false);
+        printResults("STOP + START\t");
+
+        myMag.setI2CRepeatedStart(true);
+        printResults("Repeated START\t");
+    }
+
+    // Back to the defaults
+    myMag.setI2CRepeatedStart(false);
+    Wire.setClock(100000);
+
+    delay(5000);
+}
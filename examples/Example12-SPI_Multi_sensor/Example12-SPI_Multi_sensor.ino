@@ -0,0 +1,84 @@
+/*
+  Time-aligned measurements from several MMC5983MA sensors on one SPI bus
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example triggers two sensors together and prints the difference between their
+  readings (a simple gradiometer). The group runs each trigger and read sweep inside one
+  SPI transaction, so the measurements start within a few microseconds of each other.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS of the first sensor to pin 4, and CS of the second sensor to pin 5.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Group.h>
+
+SFE_MMC5983MA magA;
+SFE_MMC5983MA magB;
+
+SFE_MMC5983MA *sensors[] = {&magA, &magB};
+SFE_MMC5983MA_Group group(sensors, 2);
+
+int csPinA = 4;
+int csPinB = 5;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    if ((magA.begin(csPinA) == false) || (magB.begin(csPinB) == false))
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    magA.softReset();
+    magB.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    // Use the fastest filter bandwidth on both sensors
+    magA.setFilterBandwidth(800);
+    magB.setFilterBandwidth(800);
+}
+
+void loop()
+{
+    SFE_MMC5983MA_Frame frames[2];
+
+    if (group.measureAll(frames) == false)
+    {
+        Serial.println("Measurement failed");
+        delay(100);
+        return;
+    }
+
+    // The full scale is +/- 8 Gauss, 16384 counts per Gauss
+    double gradientX = ((double)frames[0].x - (double)frames[1].x) / 16384.0;
+    double gradientY = ((double)frames[0].y - (double)frames[1].y) / 16384.0;
+    double gradientZ = ((double)frames[0].z - (double)frames[1].z) / 16384.0;
+
+    Serial.print("Gradient X: ");
+    Serial.print(gradientX, 5);
+    Serial.print(" Gauss\tY: ");
+    Serial.print(gradientY, 5);
+    Serial.print(" Gauss\tZ: ");
+    Serial.print(gradientZ, 5);
+    Serial.print(" Gauss\tTrigger skew: ");
+    Serial.print(group.getTriggerSkew());
+    Serial.println(" us");
+
+    delay(100);
+}
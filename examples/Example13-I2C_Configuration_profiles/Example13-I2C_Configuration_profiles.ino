@@ -0,0 +1,85 @@
+/*
+  Switching between configuration profiles on the MMC5983MA
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example builds two configuration profiles at compile time and switches between
+  them every few seconds. Each switch is a single write of the four control registers,
+  instead of one bus transaction per setting.
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper (https://www.sparkfun.com/products/17912)
+  Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+
+SFE_MMC5983MA myMag;
+
+// 1000Hz continuous measurements at the widest bandwidth
+constexpr SFE_MMC5983MA_Profile highRate = SFE_MMC5983MA_Profile()
+                                               .withFilterBandwidth(800)
+                                               .withContinuousModeFrequency(1000)
+                                               .withContinuousMode(true);
+
+// 10Hz continuous measurements at the narrowest bandwidth, with a SET before every 25 measurements
+constexpr SFE_MMC5983MA_Profile lowNoise = SFE_MMC5983MA_Profile()
+                                               .withFilterBandwidth(100)
+                                               .withContinuousModeFrequency(10)
+                                               .withContinuousMode(true)
+                                               .withAutomaticSetReset(true)
+                                               .withPeriodicSetSamples(25)
+                                               .withPeriodicSet(true);
+
+// Invalid settings are caught by the compiler
+static_assert(highRate.isValid(), "highRate profile is invalid");
+static_assert(lowNoise.isValid(), "lowNoise profile is invalid");
+
+bool useHighRate = false;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    Wire.begin();
+    Wire.setClock(400000);
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+}
+
+void loop()
+{
+    useHighRate = !useHighRate;
+
+    unsigned long start = micros();
+    bool success = myMag.applyProfile(useHighRate ? highRate : lowNoise);
+    unsigned long elapsed = micros() - start;
+
+    Serial.print(useHighRate ? "High rate" : "Low noise");
+    Serial.print(success ? " profile applied in " : " profile failed after ");
+    Serial.print(elapsed);
+    Serial.print(" us. Bandwidth: ");
+    Serial.print(myMag.getFilterBandwidth());
+    Serial.print(" Hz, continuous mode frequency: ");
+    Serial.print(myMag.getContinuousModeFrequency());
+    Serial.println(" Hz");
+
+    delay(3000);
+}
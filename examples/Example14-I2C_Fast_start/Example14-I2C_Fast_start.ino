@@ -0,0 +1,109 @@
+/*
+  Measuring the cold and warm start times of the MMC5983MA
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example measures the time from power on (cold start) and from a soft reset
+  (warm start) to the first completed measurement. fastStart() polls the OTP_READ_DONE
+  status bit instead of waiting a fixed time, then applies the whole configuration
+  in a single write.
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper (https://www.sparkfun.com/products/17912)
+  To measure the cold start time, power the sensor from powerPin (through a load switch if needed).
+  If the sensor is always powered, set powerPin to -1: the cold start time then only includes the readiness check.
+  Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+
+SFE_MMC5983MA myMag;
+
+int powerPin = 8;
+
+constexpr SFE_MMC5983MA_Profile profile = SFE_MMC5983MA_Profile()
+                                              .withFilterBandwidth(800)
+                                              .withAutomaticSetReset(true);
+
+static_assert(profile.isValid(), "profile is invalid");
+
+// Returns the time (in microseconds) from the call to the first completed measurement, or 0 on failure
+unsigned long timeToFirstSample(bool reset)
+{
+    unsigned long start = micros();
+
+    if (myMag.fastStart(profile, reset) == false)
+        return 0;
+
+    uint32_t rawValueX = 0;
+    uint32_t rawValueY = 0;
+    uint32_t rawValueZ = 0;
+
+    if (myMag.getMeasurementXYZ(&rawValueX, &rawValueY, &rawValueZ) == false)
+        return 0;
+
+    return micros() - start;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    if (powerPin >= 0)
+    {
+        pinMode(powerPin, OUTPUT);
+        digitalWrite(powerPin, HIGH);
+        delay(20);
+    }
+
+    Wire.begin();
+    Wire.setClock(400000);
+
+    // begin() only needs to be called once. It checks the product ID with a single read.
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    Serial.println("MMC5983MA connected");
+}
+
+void loop()
+{
+    // Cold start: power cycle the sensor
+    if (powerPin >= 0)
+    {
+        digitalWrite(powerPin, LOW);
+        delay(100);
+        digitalWrite(powerPin, HIGH);
+    }
+
+    unsigned long coldStart = timeToFirstSample(false);
+
+    // Warm start: soft reset the sensor
+    unsigned long warmStart = timeToFirstSample(true);
+
+    Serial.print("Cold start to first sample: ");
+    if (coldStart > 0)
+        Serial.print(coldStart);
+    else
+        Serial.print("failed");
+    Serial.print(" us\tWarm start to first sample: ");
+    if (warmStart > 0)
+        Serial.print(warmStart);
+    else
+        Serial.print("failed");
+    Serial.println(" us");
+
+    delay(2000);
+}
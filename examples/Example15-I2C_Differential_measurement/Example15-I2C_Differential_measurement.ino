@@ -0,0 +1,86 @@
+/*
+  Offset-free measurements using SET/RESET differential acquisition
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example removes the bridge offset automatically (see Example7 for the manual method).
+  The offset is estimated from a RESET and a SET measurement every 100 samples, and again
+  whenever the temperature moves by 2C. The samples in between are single-shot measurements
+  with the offset subtracted, so the sample rate is close to the raw single-shot rate.
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper (https://www.sparkfun.com/products/17912)
+  Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Differential.h>
+
+SFE_MMC5983MA myMag;
+SFE_MMC5983MA_Differential differential(myMag);
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    Wire.begin();
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    // The differential mode does its own SET and RESET operations
+    myMag.disableAutomaticSetReset();
+
+    differential.setEstimateInterval(100);
+    differential.setTemperatureThreshold(2, 100);
+}
+
+void loop()
+{
+    uint32_t currentX = 0;
+    uint32_t currentY = 0;
+    uint32_t currentZ = 0;
+
+    differential.getMeasurementXYZ(&currentX, &currentY, &currentZ);
+
+    // The full scale is +/- 8 Gauss, 131072 counts either side of zero
+    double scaledX = ((double)currentX - 131072.0) / 131072.0 * 8.0;
+    double scaledY = ((double)currentY - 131072.0) / 131072.0 * 8.0;
+    double scaledZ = ((double)currentZ - 131072.0) / 131072.0 * 8.0;
+
+    int32_t offsetX = 0;
+    int32_t offsetY = 0;
+    int32_t offsetZ = 0;
+    differential.getOffset(&offsetX, &offsetY, &offsetZ);
+
+    Serial.print("X: ");
+    Serial.print(scaledX, 5);
+    Serial.print(" Gauss\tY: ");
+    Serial.print(scaledY, 5);
+    Serial.print(" Gauss\tZ: ");
+    Serial.print(scaledZ, 5);
+    Serial.print(" Gauss\tOffset (counts): ");
+    Serial.print(offsetX);
+    Serial.print(", ");
+    Serial.print(offsetY);
+    Serial.print(", ");
+    Serial.println(offsetZ);
+
+    delay(100);
+}
@@ -0,0 +1,112 @@
+/*
+  Temperature compensated bridge offset from a cache of SET/RESET estimates
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  The bridge offset drifts with the die temperature. This example keeps a table of offsets
+  indexed by temperature. A SET/RESET estimate is only made when the temperature moves into
+  a bin which has no estimate yet; the rest of the time the offset is interpolated from the
+  table and subtracted from plain single-shot measurements.
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper (https://www.sparkfun.com/products/17912)
+  Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Differential.h>
+#include <SparkFun_MMC5983MA_OffsetCache.h>
+
+SFE_MMC5983MA myMag;
+SFE_MMC5983MA_Differential differential(myMag);
+
+// 16 bins of 16 raw counts (about 12.5C) each
+SFE_MMC5983MA_OffsetCache<16> offsetCache;
+
+unsigned long lastTemperatureCheck = 0;
+
+// Reads the temperature and makes a SET/RESET estimate if its bin is still empty
+void updateTemperature()
+{
+    uint8_t rawTemperature = 0;
+    if (myMag.getTemperatureRaw(&rawTemperature) == false)
+        return;
+
+    if (offsetCache.needsEstimate(rawTemperature) && differential.estimateOffset())
+    {
+        int32_t offsetX = 0;
+        int32_t offsetY = 0;
+        int32_t offsetZ = 0;
+        differential.getOffset(&offsetX, &offsetY, &offsetZ);
+        offsetCache.addEstimate(rawTemperature, offsetX, offsetY, offsetZ);
+
+        Serial.print("New offset estimate at raw temperature ");
+        Serial.print(rawTemperature);
+        Serial.print(". Bins filled: ");
+        Serial.println(offsetCache.getFilledBins());
+    }
+
+    offsetCache.setTemperature(rawTemperature);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    Wire.begin();
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    // The SET/RESET estimates are made by the library
+    myMag.disableAutomaticSetReset();
+
+    updateTemperature();
+    lastTemperatureCheck = millis();
+}
+
+void loop()
+{
+    // Check the temperature once per second
+    if (millis() - lastTemperatureCheck >= 1000)
+    {
+        updateTemperature();
+        lastTemperatureCheck = millis();
+    }
+
+    uint32_t currentX = 0;
+    uint32_t currentY = 0;
+    uint32_t currentZ = 0;
+
+    myMag.getMeasurementXYZ(&currentX, &currentY, &currentZ);
+
+    // Remove the offset for the current temperature: three subtractions
+    offsetCache.apply(&currentX, &currentY, &currentZ);
+
+    // The full scale is +/- 8 Gauss, 131072 counts either side of zero
+    Serial.print("X: ");
+    Serial.print(((double)currentX - 131072.0) / 131072.0 * 8.0, 5);
+    Serial.print(" Gauss\tY: ");
+    Serial.print(((double)currentY - 131072.0) / 131072.0 * 8.0, 5);
+    Serial.print(" Gauss\tZ: ");
+    Serial.print(((double)currentZ - 131072.0) / 131072.0 * 8.0, 5);
+    Serial.println(" Gauss");
+
+    delay(100);
+}
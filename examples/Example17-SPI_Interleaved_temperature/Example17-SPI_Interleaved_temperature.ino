@@ -0,0 +1,96 @@
+/*
+  Interleaving temperature conversions with magnetic measurements over SPI
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example starts a temperature conversion after every 100th magnetic measurement:
+  readFrame() starts it once that measurement is done, so the temperature is tracked
+  without a separate blocking read. The two conversions cannot run at the same time,
+  so the startMeasurement() which follows waits for the temperature conversion to finish.
+  The temperature is returned in hundredths of a degree C, without any floating point.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS to pin 4 on an Arduino.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+
+SFE_MMC5983MA myMag;
+
+int csPin = 4;
+
+unsigned long sampleCount = 0;
+unsigned long lastReport = 0;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    if (myMag.begin(csPin) == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    myMag.setFilterBandwidth(800);
+
+    // Measure the temperature after every 100th magnetic measurement
+    myMag.setTemperatureInterval(100);
+
+    myMag.startMeasurement();
+    lastReport = millis();
+}
+
+void loop()
+{
+    if (myMag.isMeasurementReady())
+    {
+        // readFrame() collects the fields, and the temperature when one has been measured
+        SFE_MMC5983MA_Frame frame;
+        myMag.readFrame(&frame);
+
+        myMag.startMeasurement();
+
+        sampleCount++;
+    }
+
+    if (millis() - lastReport >= 1000)
+    {
+        int16_t centiDegrees = 0;
+        myMag.getLatestTemperature(&centiDegrees);
+
+        Serial.print("Samples per second: ");
+        Serial.print(sampleCount);
+        Serial.print("\tTemperature: ");
+
+        // Print the sign separately: -0.5 C has a whole part of 0
+        if (centiDegrees < 0)
+            Serial.print("-");
+        int16_t magnitude = (centiDegrees < 0) ? -centiDegrees : centiDegrees;
+        Serial.print(magnitude / 100);
+        Serial.print(".");
+        int16_t hundredths = magnitude % 100;
+        if (hundredths < 10)
+            Serial.print("0");
+        Serial.print(hundredths);
+        Serial.println(" C");
+
+        sampleCount = 0;
+        lastReport = millis();
+    }
+}
@@ -0,0 +1,136 @@
+/*
+  Calibrated micro-Gauss output with integer math only
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example converts raw readings to calibrated fields in micro-Gauss, applying a hard-iron
+  offset and a soft-iron matrix with fixed-point math, and times it against the same offset and
+  matrix in double. Both loops read their inputs from, and write their results to, volatile
+  variables, so the compiler cannot hoist or drop either one. On boards without a floating point
+  unit (e.g. Cortex-M0+) the fixed-point path is much faster.
+
+  Replace the offset and matrix below with your own calibration (see Example19).
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper (https://www.sparkfun.com/products/17912)
+  Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Calibration.h>
+
+SFE_MMC5983MA myMag;
+SFE_MMC5983MA_Calibration calibration;
+
+// Soft-iron matrix in Q16: 65536 = 1.0
+const int32_t softIron[3][3] = {
+    {65536, 0, 0},
+    {0, 65536, 0},
+    {0, 0, 65536}};
+
+// Hard-iron offset in counts
+const int32_t hardIron[3] = {0, 0, 0};
+
+// 1 count = 8 Gauss / 131072 = 15625/256 uG
+const double microGaussPerCount = 15625.0 / 256.0;
+
+// The same calibration in double, in uG per count
+double doubleMatrix[3][3];
+
+const int iterations = 1000;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    Wire.begin();
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    calibration.setOffset(hardIron[0], hardIron[1], hardIron[2]);
+    calibration.setMatrix(softIron);
+
+    for (int row = 0; row < 3; row++)
+    {
+        for (int column = 0; column < 3; column++)
+            doubleMatrix[row][column] = softIron[row][column] / 65536.0 * microGaussPerCount;
+    }
+}
+
+void loop()
+{
+    uint32_t rawX = 0;
+    uint32_t rawY = 0;
+    uint32_t rawZ = 0;
+    myMag.getMeasurementXYZ(&rawX, &rawY, &rawZ);
+
+    // Read back on every iteration, so neither loop can be computed once
+    volatile uint32_t inputX = rawX;
+    volatile uint32_t inputY = rawY;
+    volatile uint32_t inputZ = rawZ;
+
+    // Fixed point
+    volatile int32_t x = 0;
+    volatile int32_t y = 0;
+    volatile int32_t z = 0;
+    unsigned long start = micros();
+    for (int i = 0; i < iterations; i++)
+    {
+        int32_t resultX, resultY, resultZ;
+        calibration.apply(inputX, inputY, inputZ, &resultX, &resultY, &resultZ);
+        x = resultX;
+        y = resultY;
+        z = resultZ;
+    }
+    unsigned long fixedMicros = micros() - start;
+
+    // Double: the same offset and matrix
+    volatile double doubleX = 0;
+    volatile double doubleY = 0;
+    volatile double doubleZ = 0;
+    start = micros();
+    for (int i = 0; i < iterations; i++)
+    {
+        double countsX = (double)inputX - 131072.0 - hardIron[0];
+        double countsY = (double)inputY - 131072.0 - hardIron[1];
+        double countsZ = (double)inputZ - 131072.0 - hardIron[2];
+        doubleX = doubleMatrix[0][0] * countsX + doubleMatrix[0][1] * countsY + doubleMatrix[0][2] * countsZ;
+        doubleY = doubleMatrix[1][0] * countsX + doubleMatrix[1][1] * countsY + doubleMatrix[1][2] * countsZ;
+        doubleZ = doubleMatrix[2][0] * countsX + doubleMatrix[2][1] * countsY + doubleMatrix[2][2] * countsZ;
+    }
+    unsigned long doubleMicros = micros() - start;
+
+    Serial.print("X: ");
+    Serial.print(x);
+    Serial.print(" uG\tY: ");
+    Serial.print(y);
+    Serial.print(" uG\tZ: ");
+    Serial.print(z);
+    Serial.print(" uG\tFixed point: ");
+    Serial.print(fixedMicros);
+    Serial.print(" us per ");
+    Serial.print(iterations);
+    Serial.print("\tDouble: ");
+    Serial.print(doubleMicros);
+    Serial.print(" us per ");
+    Serial.println(iterations);
+
+    delay(500);
+}
@@ -0,0 +1,151 @@
+/*
+  Hard-iron and soft-iron calibration in the field, without storing samples
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example feeds raw readings into a streaming ellipsoid fit. Only the sums needed by the
+  fit are kept, so it can run for as long as you like in a few hundred bytes of RAM.
+
+  Slowly rotate the sensor (and whatever it is mounted in) through as many orientations as you
+  can. Once the coverage reaches 80% the fit is solved and loaded into the fixed-point
+  calibration stage, and the calibrated field is printed. Its strength should stay (nearly)
+  constant however the sensor is turned. Copy the offset and matrix into Example18 to reuse them.
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper (https://www.sparkfun.com/products/17912)
+  Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Calibration.h>
+#include <SparkFun_MMC5983MA_EllipsoidFit.h>
+
+SFE_MMC5983MA myMag;
+SFE_MMC5983MA_EllipsoidFit ellipsoidFit;
+SFE_MMC5983MA_Calibration calibration;
+
+bool calibrated = false;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    Wire.begin();
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    // 100Hz continuous measurements
+    myMag.setFilterBandwidth(100);
+    myMag.setContinuousModeFrequency(100);
+    myMag.enableAutomaticSetReset();
+    myMag.enableContinuousMode();
+
+    Serial.println("Rotate the sensor through as many orientations as you can");
+}
+
+void loop()
+{
+    uint32_t rawX = 0;
+    uint32_t rawY = 0;
+    uint32_t rawZ = 0;
+    myMag.readFieldsXYZ(&rawX, &rawY, &rawZ);
+
+    if (!calibrated)
+    {
+        ellipsoidFit.addSample(rawX, rawY, rawZ);
+
+        if ((ellipsoidFit.getSampleCount() % 100) == 0)
+        {
+            Serial.print("Samples: ");
+            Serial.print(ellipsoidFit.getSampleCount());
+            Serial.print("\tCoverage: ");
+            Serial.print(ellipsoidFit.getCoverage());
+            Serial.println("%");
+
+            if ((ellipsoidFit.getCoverage() >= 80) && ellipsoidFit.solve() && ellipsoidFit.applyTo(calibration))
+            {
+                calibrated = true;
+                printCalibration();
+            }
+        }
+
+        delay(10);
+        return;
+    }
+
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t z = 0;
+    calibration.apply(rawX, rawY, rawZ, &x, &y, &z);
+
+    double strength = sqrt(((double)x * x) + ((double)y * y) + ((double)z * z));
+
+    Serial.print("X: ");
+    Serial.print(x);
+    Serial.print(" uG\tY: ");
+    Serial.print(y);
+    Serial.print(" uG\tZ: ");
+    Serial.print(z);
+    Serial.print(" uG\tStrength: ");
+    Serial.print(strength, 0);
+    Serial.println(" uG");
+
+    delay(100);
+}
+
+void printCalibration()
+{
+    int32_t offsetX = 0;
+    int32_t offsetY = 0;
+    int32_t offsetZ = 0;
+    ellipsoidFit.getOffset(&offsetX, &offsetY, &offsetZ);
+
+    int32_t softIron[3][3];
+    ellipsoidFit.getMatrix(softIron);
+
+    Serial.println();
+    Serial.print("Fit error: ");
+    Serial.print(ellipsoidFit.getFitError() * 100.0, 3);
+    Serial.println("%");
+    Serial.print("Field strength: ");
+    Serial.print(ellipsoidFit.getFieldStrength() / 16384.0, 4);
+    Serial.println(" Gauss");
+
+    Serial.print("Hard-iron offset (counts): ");
+    Serial.print(offsetX);
+    Serial.print(", ");
+    Serial.print(offsetY);
+    Serial.print(", ");
+    Serial.println(offsetZ);
+
+    Serial.println("Soft-iron matrix (Q16):");
+    for (int row = 0; row < 3; row++)
+    {
+        Serial.print("    {");
+        for (int column = 0; column < 3; column++)
+        {
+            Serial.print(softIron[row][column]);
+            if (column < 2)
+                Serial.print(", ");
+        }
+        Serial.println(row < 2 ? "}," : "}};");
+    }
+    Serial.println();
+}
@@ -0,0 +1,168 @@
+/*
+  Integer heading kernel: accuracy and speed against atan2
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example first benchmarks the library's integer heading against atan2 on doubles (as used
+  in Example2): it sweeps a field vector around the full circle, reporting the maximum error of
+  the FAST and PRECISE kernels, and times each of them, the batch variant and atan2. The
+  benchmark does not need the sensor. On boards without a floating point unit the integer
+  kernels are several times faster.
+
+  It then prints the live heading, level and tilt-compensated. Replace the gravity vector below
+  with a reading from your accelerometer (axes aligned with the magnetometer).
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper (https://www.sparkfun.com/products/17912)
+  Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Heading.h>
+
+SFE_MMC5983MA myMag;
+
+// Gravity as measured by an accelerometer at rest: (0, 0, +1g) when level
+int16_t gravity[3] = {0, 0, 16384};
+
+const int steps = 3600; // One every 0.1 degrees
+const int32_t fieldStrength = 8192; // 0.5 Gauss in counts
+
+SFE_MMC5983MA_Frame frames[32];
+uint16_t headings[32];
+
+bool connected = false;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    benchmark();
+
+    Wire.begin();
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Benchmark only.");
+        return;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+    connected = true;
+}
+
+void loop()
+{
+    if (!connected)
+        return;
+
+    uint32_t rawX = 0;
+    uint32_t rawY = 0;
+    uint32_t rawZ = 0;
+    myMag.getMeasurementXYZ(&rawX, &rawY, &rawZ);
+
+    int32_t x = (int32_t)rawX - 131072;
+    int32_t y = (int32_t)rawY - 131072;
+    int32_t z = (int32_t)rawZ - 131072;
+
+    Serial.print("Heading: ");
+    Serial.print(SFE_MMC5983MA_Heading::getHeading(x, y) / 100.0, 2);
+    Serial.print("\tTilt-compensated: ");
+    Serial.println(SFE_MMC5983MA_Heading::getHeading(x, y, z, gravity) / 100.0, 2);
+
+    delay(100);
+}
+
+// Heading from atan2 on doubles, in degrees, as in Example2
+double referenceHeading(int32_t x, int32_t y)
+{
+    return (atan2((double)x, 0 - (double)y) / PI * 180.0) + 180.0;
+}
+
+// Smallest difference between two headings, in degrees
+double headingError(double heading, double reference)
+{
+    double error = fabs(heading - reference);
+    if (error > 180.0)
+        error = 360.0 - error;
+    return error;
+}
+
+void benchmark()
+{
+    Serial.println();
+    Serial.println("Kernel\tMax error (degrees)\tTime (us per heading)");
+
+    SFE_MMC5983MA_HeadingAccuracy accuracies[2] = {SFE_MMC5983MA_HeadingAccuracy::FAST, SFE_MMC5983MA_HeadingAccuracy::PRECISE};
+    const char *names[2] = {"FAST", "PRECISE"};
+
+    for (int i = 0; i < 2; i++)
+    {
+        double maxError = 0;
+        unsigned long elapsed = 0;
+
+        for (int step = 0; step < steps; step++)
+        {
+            double angle = step * 2.0 * PI / steps;
+            int32_t x = (int32_t)(fieldStrength * cos(angle));
+            int32_t y = (int32_t)(fieldStrength * sin(angle));
+
+            unsigned long start = micros();
+            uint16_t heading = SFE_MMC5983MA_Heading::getHeading(x, y, accuracies[i]);
+            elapsed += micros() - start;
+
+            double error = headingError(heading / 100.0, referenceHeading(x, y));
+            if (error > maxError)
+                maxError = error;
+        }
+
+        Serial.print(names[i]);
+        Serial.print("\t");
+        Serial.print(maxError, 4);
+        Serial.print("\t\t\t");
+        Serial.println((double)elapsed / steps, 2);
+    }
+
+    // atan2 on doubles
+    volatile double sink = 0;
+    unsigned long elapsed = 0;
+    for (int step = 0; step < steps; step++)
+    {
+        double angle = step * 2.0 * PI / steps;
+        int32_t x = (int32_t)(fieldStrength * cos(angle));
+        int32_t y = (int32_t)(fieldStrength * sin(angle));
+
+        unsigned long start = micros();
+        sink = referenceHeading(x, y);
+        elapsed += micros() - start;
+    }
+    Serial.print("atan2\t0\t\t\t");
+    Serial.println((double)elapsed / steps, 2);
+
+    // Batch of raw frames, tilt-compensated
+    const uint16_t count = sizeof(frames) / sizeof(frames[0]);
+    for (uint16_t i = 0; i < count; i++)
+    {
+        double angle = i * 2.0 * PI / count;
+        frames[i].x = (uint32_t)(131072 + (int32_t)(fieldStrength * cos(angle)));
+        frames[i].y = (uint32_t)(131072 + (int32_t)(fieldStrength * sin(angle)));
+        frames[i].z = 131072;
+    }
+    unsigned long start = micros();
+    SFE_MMC5983MA_Heading::getHeadings(frames, headings, count, nullptr, gravity);
+    elapsed = micros() - start;
+
+    Serial.print("Batch, tilt-compensated (PRECISE)\t\t");
+    Serial.println((double)elapsed / count, 2);
+    Serial.println();
+}
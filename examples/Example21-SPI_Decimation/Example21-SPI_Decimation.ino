@@ -0,0 +1,211 @@
+/*
+  Low-noise output by oversampling and decimation
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example samples at 1000Hz in continuous mode and decimates the stream on the MCU with
+  SFE_MMC5983MA_Decimator, a boxcar (Order 1) and a 3rd order CIC filter side by side. For each
+  decimation factor it reports the RMS noise of the output, its improvement over the raw 1000Hz
+  stream, the noise density, and the CPU time spent filtering per output frame.
+
+  Keep the sensor still, and away from moving metal, while it runs.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS to pin 4 on an Arduino.
+  Connect INT to pin 2 on an Arduino.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Sampler.h>
+#include <SparkFun_MMC5983MA_Decimator.h>
+
+SFE_MMC5983MA myMag;
+
+// The ring capacity must be a power of two
+SFE_MMC5983MA_Sampler<64> sampler(myMag);
+
+SFE_MMC5983MA_Decimator<1> boxcar;
+SFE_MMC5983MA_Decimator<3> cic;
+
+int csPin = 4;
+
+int interruptPin = 2;
+
+const uint16_t factors[] = {1, 2, 5, 10, 20};
+const unsigned long inputsPerFactor = 10000; // 10 seconds at 1000Hz
+
+const double microGaussPerCount = 15625.0 / 256.0;
+
+double rawNoise = 0; // RMS noise of the undecimated stream, in uG
+
+// Running statistics of the output frames of one filter
+struct NoiseStats
+{
+    double sum[3];
+    double sumOfSquares[3];
+    uint32_t reference[3]; // First output, subtracted to keep the sums small
+    unsigned long outputs;
+    unsigned long filterMicros;
+
+    void clear()
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            sum[axis] = 0;
+            sumOfSquares[axis] = 0;
+        }
+        outputs = 0;
+        filterMicros = 0;
+    }
+
+    void add(const SFE_MMC5983MA_Frame &frame)
+    {
+        const uint32_t fields[3] = {frame.x, frame.y, frame.z};
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (outputs == 0)
+                reference[axis] = fields[axis];
+            double value = (double)fields[axis] - (double)reference[axis];
+            sum[axis] += value;
+            sumOfSquares[axis] += value * value;
+        }
+        outputs++;
+    }
+
+    // RMS noise in uG, averaged over the three axes
+    double noise()
+    {
+        if (outputs < 2)
+            return 0;
+        double variance = 0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            double mean = sum[axis] / outputs;
+            variance += (sumOfSquares[axis] / outputs) - (mean * mean);
+        }
+        return sqrt(variance / 3) * microGaussPerCount;
+    }
+};
+
+NoiseStats boxcarStats;
+NoiseStats cicStats;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    while (myMag.begin(csPin) == false)
+    {
+        Serial.println("MMC5983MA did not respond. Retrying...");
+        delay(500);
+        myMag.softReset();
+        delay(500);
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    // 1000Hz continuous mode needs the 800Hz filter bandwidth
+    myMag.setFilterBandwidth(800);
+    myMag.setContinuousModeFrequency(1000);
+    myMag.enableAutomaticSetReset();
+    myMag.enableInterrupt();
+
+    // The ISR uses SPI, so tell the SPI library to protect its transactions from it
+    pinMode(interruptPin, INPUT);
+    SPI.usingInterrupt(digitalPinToInterrupt(interruptPin));
+    attachInterrupt(digitalPinToInterrupt(interruptPin), interruptRoutine, RISING);
+
+    myMag.enableContinuousMode();
+
+    Serial.println();
+    Serial.println("Factor\tRate (Hz)\tFilter\tNoise (uG RMS)\tImprovement\tDensity (uG/rtHz)\tCPU (us per output)\tOverruns");
+}
+
+void loop()
+{
+    for (uint8_t i = 0; i < sizeof(factors) / sizeof(factors[0]); i++)
+        measure(factors[i]);
+
+    Serial.println();
+}
+
+void measure(uint16_t factor)
+{
+    boxcar.setFactor(factor);
+    cic.setFactor(factor);
+    boxcarStats.clear();
+    cicStats.clear();
+
+    // Start from an empty ring
+    SFE_MMC5983MA_Frame inputs[16];
+    while (sampler.drain(inputs, 16) > 0)
+        ;
+    uint32_t overruns = sampler.getOverruns();
+
+    unsigned long inputCount = 0;
+    while (inputCount < inputsPerFactor)
+    {
+        uint8_t count = sampler.drain(inputs, 16);
+        inputCount += count;
+
+        SFE_MMC5983MA_Frame outputs[17];
+
+        unsigned long start = micros();
+        uint16_t produced = boxcar.process(inputs, count, outputs);
+        boxcarStats.filterMicros += micros() - start;
+        for (uint16_t j = 0; j < produced; j++)
+            boxcarStats.add(outputs[j]);
+
+        start = micros();
+        produced = cic.process(inputs, count, outputs);
+        cicStats.filterMicros += micros() - start;
+        for (uint16_t j = 0; j < produced; j++)
+            cicStats.add(outputs[j]);
+    }
+
+    if (factor == 1)
+        rawNoise = boxcarStats.noise();
+
+    report(factor, "Boxcar", boxcarStats, sampler.getOverruns() - overruns);
+    report(factor, "CIC3", cicStats, sampler.getOverruns() - overruns);
+}
+
+void report(uint16_t factor, const char *filter, NoiseStats &stats, uint32_t overruns)
+{
+    double rate = 1000.0 / factor;
+    double noise = stats.noise();
+
+    Serial.print(factor);
+    Serial.print("\t");
+    Serial.print(rate, 0);
+    Serial.print("\t\t");
+    Serial.print(filter);
+    Serial.print("\t");
+    Serial.print(noise, 1);
+    Serial.print("\t\t");
+    Serial.print((noise > 0) ? rawNoise / noise : 0, 2);
+    Serial.print("\t\t");
+    // White noise spread over the output bandwidth (half the output rate)
+    Serial.print(noise / sqrt(rate / 2), 2);
+    Serial.print("\t\t\t");
+    Serial.print((stats.outputs > 0) ? (double)stats.filterMicros / stats.outputs : 0, 2);
+    Serial.print("\t\t\t");
+    Serial.println(overruns);
+}
+
+void interruptRoutine()
+{
+    sampler.sample();
+}
@@ -0,0 +1,139 @@
+/*
+  Sharing the latest frame with several readers, without a mutex
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example attaches an SFE_MMC5983MA_LatestFrame to the driver. The INT pin ISR reads each
+  1000Hz continuous mode frame, and the driver publishes it into the slot with a timestamp and
+  a sequence number. Readers (here two "tasks" in loop(), running at different rates; on an RTOS
+  they can be real tasks) take consistent snapshots of the latest frame without using the bus,
+  and without ever holding up the ISR. The sequence number shows how many frames each reader skipped.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS to pin 4 on an Arduino.
+  Connect INT to pin 2 on an Arduino.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_LatestFrame.h>
+
+SFE_MMC5983MA myMag;
+
+SFE_MMC5983MA_LatestFrame latestFrame;
+
+int csPin = 4;
+
+int interruptPin = 2;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    while (myMag.begin(csPin) == false)
+    {
+        Serial.println("MMC5983MA did not respond. Retrying...");
+        delay(500);
+        myMag.softReset();
+        delay(500);
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    // Every frame the driver reads is published into latestFrame
+    myMag.addFrameSink(&latestFrame);
+
+    // 1000Hz continuous mode needs the 800Hz filter bandwidth
+    myMag.setFilterBandwidth(800);
+    myMag.setContinuousModeFrequency(1000);
+    myMag.enableAutomaticSetReset();
+    myMag.enableInterrupt();
+
+    // The ISR uses SPI, so tell the SPI library to protect its transactions from it
+    pinMode(interruptPin, INPUT);
+    SPI.usingInterrupt(digitalPinToInterrupt(interruptPin));
+    attachInterrupt(digitalPinToInterrupt(interruptPin), interruptRoutine, RISING);
+
+    myMag.enableContinuousMode();
+}
+
+void loop()
+{
+    static unsigned long lastControl = 0;
+    static unsigned long lastTelemetry = 0;
+
+    // A fast "control loop" reader at 100Hz
+    if (millis() - lastControl >= 10)
+    {
+        lastControl = millis();
+        controlTask();
+    }
+
+    // A slow "telemetry" reader at 1Hz
+    if (millis() - lastTelemetry >= 1000)
+    {
+        lastTelemetry = millis();
+        telemetryTask();
+    }
+}
+
+void controlTask()
+{
+    static uint32_t lastSequence = 0;
+
+    SFE_MMC5983MA_Sample sample;
+    if (!latestFrame.read(&sample))
+        return;
+
+    // Only act on new frames
+    if (sample.sequence == lastSequence)
+        return;
+    lastSequence = sample.sequence;
+
+    // Use sample.frame.x, .y and .z here
+}
+
+void telemetryTask()
+{
+    static uint32_t lastSequence = 0;
+
+    SFE_MMC5983MA_Sample sample;
+    if (!latestFrame.read(&sample))
+    {
+        Serial.println("No frames yet");
+        return;
+    }
+
+    Serial.print("Frame ");
+    Serial.print(sample.sequence);
+    Serial.print(" (");
+    Serial.print(sample.sequence - lastSequence);
+    Serial.print(" since the last report), read ");
+    Serial.print(micros() - sample.timestamp);
+    Serial.print(" us ago\tX: ");
+    Serial.print(sample.frame.x);
+    Serial.print("\tY: ");
+    Serial.print(sample.frame.y);
+    Serial.print("\tZ: ");
+    Serial.println(sample.frame.z);
+
+    lastSequence = sample.sequence;
+}
+
+void interruptRoutine()
+{
+    // readFrame() clears the interrupt and publishes the frame
+    SFE_MMC5983MA_Frame frame;
+    myMag.readFrame(&frame);
+}
@@ -0,0 +1,181 @@
+/*
+  Fanning the frame stream out to several processing stages without copying
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example attaches an SFE_MMC5983MA_Broadcast ring to the driver. The INT pin ISR reads each
+  1000Hz continuous mode frame and the driver writes it into the ring once. Three stages subscribe
+  to the ring and each reads every frame in place, at its own pace:
+    a decimating filter (100Hz output),
+    an anomaly detector (flags sudden jumps in the field),
+    a logger, which only runs once a second and so falls behind on purpose.
+  The ISR is never held up by a slow stage. Instead the ring reports the frames that stage dropped.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS to pin 4 on an Arduino.
+  Connect INT to pin 2 on an Arduino.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Broadcast.h>
+#include <SparkFun_MMC5983MA_Decimator.h>
+
+SFE_MMC5983MA myMag;
+
+// 128 frames (128ms at 1000Hz), up to 4 subscribers
+SFE_MMC5983MA_Broadcast<128> broadcast;
+
+SFE_MMC5983MA_Decimator<2> decimator(10);
+
+int8_t filterSubscriber;
+int8_t detectorSubscriber;
+int8_t loggerSubscriber;
+
+const int32_t jumpThreshold = 1638; // 0.1 Gauss in counts
+
+unsigned long filteredFrames = 0;
+unsigned long anomalies = 0;
+
+int csPin = 4;
+
+int interruptPin = 2;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    while (myMag.begin(csPin) == false)
+    {
+        Serial.println("MMC5983MA did not respond. Retrying...");
+        delay(500);
+        myMag.softReset();
+        delay(500);
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    filterSubscriber = broadcast.subscribe();
+    detectorSubscriber = broadcast.subscribe();
+    loggerSubscriber = broadcast.subscribe();
+
+    // Every frame the driver reads is written into the ring
+    myMag.addFrameSink(&broadcast);
+
+    // 1000Hz continuous mode needs the 800Hz filter bandwidth
+    myMag.setFilterBandwidth(800);
+    myMag.setContinuousModeFrequency(1000);
+    myMag.enableAutomaticSetReset();
+    myMag.enableInterrupt();
+
+    // The ISR uses SPI, so tell the SPI library to protect its transactions from it
+    pinMode(interruptPin, INPUT);
+    SPI.usingInterrupt(digitalPinToInterrupt(interruptPin));
+    attachInterrupt(digitalPinToInterrupt(interruptPin), interruptRoutine, RISING);
+
+    myMag.enableContinuousMode();
+}
+
+void loop()
+{
+    filterStage();
+    detectorStage();
+
+    static unsigned long lastLog = 0;
+    if (millis() - lastLog >= 1000)
+    {
+        lastLog = millis();
+        loggerStage();
+    }
+}
+
+void filterStage()
+{
+    const SFE_MMC5983MA_Frame *frames;
+    uint16_t count = broadcast.peek(filterSubscriber, &frames);
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        SFE_MMC5983MA_Frame output;
+        if (decimator.push(frames[i], &output))
+            filteredFrames++; // Use the 100Hz output frame here
+    }
+
+    broadcast.release(filterSubscriber, count);
+}
+
+void detectorStage()
+{
+    static SFE_MMC5983MA_Frame previous;
+    static bool havePrevious = false;
+
+    const SFE_MMC5983MA_Frame *frames;
+    uint16_t count = broadcast.peek(detectorSubscriber, &frames);
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (havePrevious && ((abs((int32_t)frames[i].x - (int32_t)previous.x) > jumpThreshold) ||
+                             (abs((int32_t)frames[i].y - (int32_t)previous.y) > jumpThreshold) ||
+                             (abs((int32_t)frames[i].z - (int32_t)previous.z) > jumpThreshold)))
+            anomalies++;
+        previous = frames[i];
+        havePrevious = true;
+    }
+
+    broadcast.release(detectorSubscriber, count);
+}
+
+void loggerStage()
+{
+    // Runs once a second, so most frames have been overwritten by now. Log the newest ones available.
+    const SFE_MMC5983MA_Frame *frames;
+    const uint32_t *timestamps;
+    uint16_t count = broadcast.peek(loggerSubscriber, &frames, &timestamps);
+    if (count == 0)
+        return;
+
+    SFE_MMC5983MA_Frame last = frames[count - 1];
+    uint32_t lastTimestamp = timestamps[count - 1];
+
+    // Only print the frame if it was not overwritten while we copied it
+    if (broadcast.release(loggerSubscriber, count))
+    {
+        Serial.print("Frame at ");
+        Serial.print(lastTimestamp);
+        Serial.print(" us\tX: ");
+        Serial.print(last.x);
+        Serial.print("\tY: ");
+        Serial.print(last.y);
+        Serial.print("\tZ: ");
+        Serial.print(last.z);
+    }
+
+    Serial.print("\tFiltered: ");
+    Serial.print(filteredFrames);
+    Serial.print("\tAnomalies: ");
+    Serial.print(anomalies);
+    Serial.print("\tDropped by filter/detector/logger: ");
+    Serial.print(broadcast.getDroppedFrames(filterSubscriber));
+    Serial.print("/");
+    Serial.print(broadcast.getDroppedFrames(detectorSubscriber));
+    Serial.print("/");
+    Serial.println(broadcast.getDroppedFrames(loggerSubscriber));
+}
+
+void interruptRoutine()
+{
+    // readFrame() clears the interrupt and the driver writes the frame into the ring
+    SFE_MMC5983MA_Frame frame;
+    myMag.readFrame(&frame);
+}
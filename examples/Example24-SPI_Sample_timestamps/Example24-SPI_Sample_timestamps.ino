@@ -0,0 +1,150 @@
+/*
+  Timestamping each continuous mode sample on the sensor's own clock, and detecting lost samples
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  The sensor's 1000Hz output data rate comes from its own oscillator, which can be a few percent
+  off, and the time the ISR runs jitters with interrupt latency. This example puts an
+  SFE_MMC5983MA_SampleClock between the driver and an SFE_MMC5983MA_Broadcast ring. The ISR marks
+  the INT edge time first thing, then reads the frame. The clock fits the edge times to a grid of
+  evenly spaced samples, so the timestamps in the ring are free of jitter, and it counts the
+  samples which were lost (e.g. while interrupts were disabled).
+
+  Once a second the example prints the measured sample rate, the edge jitter and the samples lost.
+  Send any character to block interrupts for 5ms and watch the clock count the samples missed.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS to pin 4 on an Arduino.
+  Connect INT to pin 2 on an Arduino.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Broadcast.h>
+#include <SparkFun_MMC5983MA_SampleClock.h>
+
+SFE_MMC5983MA myMag;
+
+SFE_MMC5983MA_Broadcast<64> broadcast;
+
+// Passes each frame on to the ring with its modelled timestamp
+SFE_MMC5983MA_SampleClock sampleClock(&broadcast);
+
+int8_t subscriber;
+
+int csPin = 4;
+
+int interruptPin = 2;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    while (myMag.begin(csPin) == false)
+    {
+        Serial.println("MMC5983MA did not respond. Retrying...");
+        delay(500);
+        myMag.softReset();
+        delay(500);
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    subscriber = broadcast.subscribe();
+
+    // 1000Hz continuous mode needs the 800Hz filter bandwidth
+    myMag.setFilterBandwidth(800);
+    myMag.setContinuousModeFrequency(1000);
+    myMag.enableAutomaticSetReset();
+    myMag.enableInterrupt();
+
+    sampleClock.setNominalRate(myMag.getContinuousModeFrequency());
+    myMag.addFrameSink(&sampleClock);
+
+    // The ISR uses SPI, so tell the SPI library to protect its transactions from it
+    pinMode(interruptPin, INPUT);
+    SPI.usingInterrupt(digitalPinToInterrupt(interruptPin));
+    attachInterrupt(digitalPinToInterrupt(interruptPin), interruptRoutine, RISING);
+
+    myMag.enableContinuousMode();
+}
+
+void loop()
+{
+    static uint32_t lastTimestamp = 0;
+    static int32_t worstError = 0;
+
+    // Consume the frames. Consecutive timestamps are one period apart, or a whole number of periods after a gap.
+    const SFE_MMC5983MA_Frame *frames;
+    const uint32_t *timestamps;
+    uint16_t count = broadcast.peek(subscriber, &frames, &timestamps);
+    if (count > 0)
+    {
+        lastTimestamp = timestamps[count - 1];
+        broadcast.release(subscriber, count);
+    }
+
+    int32_t error = abs(sampleClock.getLastError());
+    if (error > worstError)
+        worstError = error;
+
+    if (Serial.available())
+    {
+        while (Serial.available())
+            Serial.read();
+        Serial.println("Blocking interrupts for 5ms");
+        noInterrupts();
+        delayMicroseconds(5000);
+        interrupts();
+    }
+
+    static unsigned long lastReport = 0;
+    if (millis() - lastReport >= 1000)
+    {
+        lastReport = millis();
+
+        uint32_t rate = sampleClock.getMeasuredRate();
+        Serial.print("Rate: ");
+        Serial.print(rate / 1000);
+        Serial.print(".");
+        uint32_t fraction = rate % 1000;
+        if (fraction < 100)
+            Serial.print("0");
+        if (fraction < 10)
+            Serial.print("0");
+        Serial.print(fraction);
+        Serial.print(" Hz\tSample: ");
+        Serial.print(sampleClock.getSampleIndex());
+        Serial.print(" at ");
+        Serial.print(lastTimestamp);
+        Serial.print(" us\tWorst edge jitter: ");
+        Serial.print(worstError);
+        Serial.print(" us\tLost: ");
+        Serial.print(sampleClock.getMissedSamples());
+        Serial.print(" in ");
+        Serial.print(sampleClock.getGapCount());
+        Serial.println(" gaps");
+
+        worstError = 0;
+    }
+}
+
+void interruptRoutine()
+{
+    // Mark the edge before anything else, then read the frame: the driver passes it to the clock
+    sampleClock.markInterrupt(micros());
+
+    SFE_MMC5983MA_Frame frame;
+    myMag.readFrame(&frame);
+}
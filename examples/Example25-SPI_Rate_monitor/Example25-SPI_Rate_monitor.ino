@@ -0,0 +1,161 @@
+/*
+  Monitoring the output data rate actually delivered, for alerting on deployed nodes
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  getContinuousModeFrequency() reports the configured rate, not the rate delivered. This example
+  attaches an SFE_MMC5983MA_RateMonitor to the driver. Every second it reports the delivered rate,
+  the jitter between frames and the latency from the INT edge to the end of the read. The driver's
+  error callback is called with DATA_RATE_TOO_LOW when a second delivers less than 90% of the
+  configured rate, and with DATA_STALLED when frames stop altogether.
+
+  Send 'b' to set a 100Hz filter bandwidth. Its 8ms measurements cannot keep up with 1000Hz, and the
+  monitor raises DATA_RATE_TOO_LOW. Send 'g' to go back to the 800Hz bandwidth.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS to pin 4 on an Arduino.
+  Connect INT to pin 2 on an Arduino.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_RateMonitor.h>
+
+SFE_MMC5983MA myMag;
+
+SFE_MMC5983MA_RateMonitor rateMonitor;
+
+// Set by the error callback, which can run in the ISR, and printed from loop()
+volatile bool rateTooLow = false;
+volatile bool stalled = false;
+
+int csPin = 4;
+
+int interruptPin = 2;
+
+void errorCallback(SF_MMC5983MA_ERROR errorCode)
+{
+    if (errorCode == SF_MMC5983MA_ERROR::DATA_RATE_TOO_LOW)
+        rateTooLow = true;
+    else if (errorCode == SF_MMC5983MA_ERROR::DATA_STALLED)
+        stalled = true;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    while (myMag.begin(csPin) == false)
+    {
+        Serial.println("MMC5983MA did not respond. Retrying...");
+        delay(500);
+        myMag.softReset();
+        delay(500);
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    myMag.setErrorCallback(errorCallback);
+
+    // 1000Hz continuous mode needs the 800Hz filter bandwidth
+    myMag.setFilterBandwidth(800);
+    myMag.setContinuousModeFrequency(1000);
+    myMag.enableAutomaticSetReset();
+    myMag.enableInterrupt();
+
+    // Attach the monitor, after setting the frequency it should expect
+    rateMonitor.setThreshold(90);
+    rateMonitor.begin(myMag);
+
+    // The ISR uses SPI, so tell the SPI library to protect its transactions from it
+    pinMode(interruptPin, INPUT);
+    SPI.usingInterrupt(digitalPinToInterrupt(interruptPin));
+    attachInterrupt(digitalPinToInterrupt(interruptPin), interruptRoutine, RISING);
+
+    myMag.enableContinuousMode();
+}
+
+void loop()
+{
+    // Detects a stream which has stopped
+    rateMonitor.check(micros());
+
+    if (Serial.available())
+    {
+        char command = Serial.read();
+        if ((command == 'b') || (command == 'g'))
+        {
+            // Stop the ISR using the bus while the bandwidth is changed
+            detachInterrupt(digitalPinToInterrupt(interruptPin));
+            myMag.setFilterBandwidth((command == 'b') ? 100 : 800);
+
+            // Clear any interrupt missed while detached, so the INT pin can rise again
+            SFE_MMC5983MA_Frame frame;
+            myMag.readFrame(&frame);
+
+            attachInterrupt(digitalPinToInterrupt(interruptPin), interruptRoutine, RISING);
+            Serial.println((command == 'b') ? "Bandwidth 100Hz" : "Bandwidth 800Hz");
+        }
+    }
+
+    if (rateTooLow)
+    {
+        rateTooLow = false;
+        Serial.println("ALERT: delivered rate below threshold");
+    }
+    if (stalled)
+    {
+        stalled = false;
+        Serial.println("ALERT: no frames");
+    }
+
+    static unsigned long lastReport = 0;
+    if (millis() - lastReport >= 1000)
+    {
+        lastReport = millis();
+
+        SFE_MMC5983MA_RateReport report;
+        rateMonitor.getReport(&report);
+
+        Serial.print("Rate: ");
+        Serial.print(report.measuredRate / 1000);
+        Serial.print(" of ");
+        Serial.print(report.configuredRate / 1000);
+        Serial.print(" Hz\tInterval: ");
+        Serial.print(report.minimumInterval);
+        Serial.print("..");
+        Serial.print(report.maximumInterval);
+        Serial.print(" us, jitter ");
+        Serial.print(report.jitter);
+        Serial.print(" us\tLatency: median <= ");
+        Serial.print(SFE_MMC5983MA_RateMonitor::getLatencyPercentile(report, 50));
+        Serial.print(" us, 99% <= ");
+        Serial.print(SFE_MMC5983MA_RateMonitor::getLatencyPercentile(report, 99));
+        Serial.print(" us, max ");
+        Serial.print(report.maximumLatency);
+        Serial.print(" us\tLow windows: ");
+        Serial.print(report.lowRateWindows);
+        Serial.print(" of ");
+        Serial.println(report.windows);
+    }
+}
+
+void interruptRoutine()
+{
+    // Mark the edge before anything else, then read the frame: the driver passes it to the monitor
+    rateMonitor.markInterrupt(micros());
+
+    SFE_MMC5983MA_Frame frame;
+    myMag.readFrame(&frame);
+}
@@ -0,0 +1,176 @@
+/*
+  Driving the sensor from a single-threaded event loop, without ever blocking
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  The blocking calls (softReset(), performSetOperation(), getMeasurementXYZ()...) wait for the
+  device with delay(), holding up anything else the loop has to service. This example uses
+  SFE_MMC5983MA_Async instead: it soft resets and configures the sensor, then measures the field
+  ten times a second, with a SET operation before each measurement and a temperature reading once
+  a second. Each step is started and then advanced by poll(), which makes at most one bus
+  transaction. Meanwhile loop() keeps blinking the LED and counts how often it runs, and reports the
+  longest single pass through it.
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper (https://www.sparkfun.com/products/17912)
+  Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+#include <SparkFun_MMC5983MA_Async.h>
+
+SFE_MMC5983MA myMag;
+
+SFE_MMC5983MA_Async asyncMag(myMag);
+
+constexpr SFE_MMC5983MA_Profile profile = SFE_MMC5983MA_Profile().withFilterBandwidth(400);
+
+// The sequence the sensor "task" works through
+enum SensorStep
+{
+    RESETTING,
+    CONFIGURING,
+    IDLE,
+    SETTING,
+    MEASURING,
+    MEASURING_TEMPERATURE
+};
+
+SensorStep sensorStep = RESETTING;
+
+unsigned long lastMeasurement = 0;
+unsigned long lastTemperature = 0;
+
+unsigned long loopCount = 0;
+unsigned long longestLoop = 0;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    pinMode(LED_BUILTIN, OUTPUT);
+
+    Wire.begin();
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    Serial.println("MMC5983MA connected");
+
+    asyncMag.startSoftReset();
+}
+
+void loop()
+{
+    unsigned long start = micros();
+
+    sensorTask();
+    blinkTask();
+
+    loopCount++;
+    unsigned long duration = micros() - start;
+    if (duration > longestLoop)
+        longestLoop = duration;
+}
+
+void sensorTask()
+{
+    SFE_MMC5983MA_AsyncStatus status = asyncMag.poll(micros());
+    if (status == SFE_MMC5983MA_AsyncStatus::PENDING)
+        return;
+
+    if (status == SFE_MMC5983MA_AsyncStatus::ERROR)
+    {
+        Serial.println("Sensor operation failed. Resetting.");
+        sensorStep = RESETTING;
+        asyncMag.startSoftReset();
+        return;
+    }
+
+    // The last operation is done: start the next one
+    switch (sensorStep)
+    {
+    case RESETTING:
+        sensorStep = CONFIGURING;
+        asyncMag.startConfigure(profile);
+        break;
+
+    case CONFIGURING:
+        sensorStep = IDLE;
+        break;
+
+    case IDLE:
+        if (millis() - lastTemperature >= 1000)
+        {
+            lastTemperature = millis();
+            sensorStep = MEASURING_TEMPERATURE;
+            asyncMag.startTemperatureMeasurement();
+        }
+        else if (millis() - lastMeasurement >= 100)
+        {
+            lastMeasurement = millis();
+            sensorStep = SETTING;
+            asyncMag.startSetOperation();
+        }
+        break;
+
+    case SETTING:
+        sensorStep = MEASURING;
+        asyncMag.startMeasurement();
+        break;
+
+    case MEASURING:
+    {
+        sensorStep = IDLE;
+
+        uint32_t x, y, z;
+        asyncMag.getFields(&x, &y, &z);
+
+        Serial.print("X: ");
+        Serial.print(x);
+        Serial.print("\tY: ");
+        Serial.print(y);
+        Serial.print("\tZ: ");
+        Serial.print(z);
+        Serial.print("\tLoop ran ");
+        Serial.print(loopCount);
+        Serial.print(" times, longest pass ");
+        Serial.print(longestLoop);
+        Serial.println(" us");
+
+        loopCount = 0;
+        longestLoop = 0;
+        break;
+    }
+
+    case MEASURING_TEMPERATURE:
+        sensorStep = IDLE;
+
+        Serial.print("Die temperature: ");
+        Serial.print(asyncMag.getTemperature() / 100);
+        Serial.println(" C");
+        break;
+    }
+}
+
+void blinkTask()
+{
+    static unsigned long lastToggle = 0;
+    if (millis() - lastToggle >= 250)
+    {
+        lastToggle = millis();
+        digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+    }
+}
@@ -0,0 +1,91 @@
+/*
+  Measuring the single-shot measurement latency of the MMC5983MA
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example times getMeasurementXYZ at each filter bandwidth setting.
+  getMeasurementXYZ sleeps for the expected measurement time (defined by BW1/0) and then
+  polls the status register every few microseconds, so the latency closely follows the
+  datasheet measurement time: 8ms, 4ms, 2ms and 0.5ms for 100, 200, 400 and 800Hz.
+
+  Hardware Connections:
+  Plug a Qwiic cable into the sensor and a RedBoard
+  If you don't have a platform with a Qwiic connection use the SparkFun Qwiic Breadboard Jumper
+  (https://www.sparkfun.com/products/17912) Open the serial monitor at 115200 baud to see the output
+*/
+
+#include <Wire.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+
+SFE_MMC5983MA myMag;
+
+const uint16_t bandwidths[] = {100, 200, 400, 800};
+const uint16_t samplesPerBandwidth = 200;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    Wire.begin();
+    Wire.setClock(400000); // Use 400kHz I2C so the bus time does not dominate
+
+    if (myMag.begin() == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+}
+
+void loop()
+{
+    Serial.println();
+    Serial.println("BW (Hz)\tExpected (us)\tMean latency (us)\tMax latency (us)\tRate (Hz)\tFailures");
+
+    for (uint8_t i = 0; i < sizeof(bandwidths) / sizeof(bandwidths[0]); i++)
+    {
+        myMag.setFilterBandwidth(bandwidths[i]);
+
+        uint32_t currentX = 0;
+        uint32_t currentY = 0;
+        uint32_t currentZ = 0;
+        unsigned long maxLatency = 0;
+        uint16_t failures = 0;
+
+        unsigned long start = micros();
+        for (uint16_t sample = 0; sample < samplesPerBandwidth; sample++)
+        {
+            unsigned long before = micros();
+            if (myMag.getMeasurementXYZ(&currentX, &currentY, &currentZ) == false)
+                failures++;
+            unsigned long latency = micros() - before;
+            if (latency > maxLatency)
+                maxLatency = latency;
+        }
+        unsigned long elapsed = micros() - start;
+
+        Serial.print(bandwidths[i]);
+        Serial.print("\t");
+        Serial.print(myMag.getMeasurementTime());
+        Serial.print("\t\t");
+        Serial.print(elapsed / samplesPerBandwidth);
+        Serial.print("\t\t\t");
+        Serial.print(maxLatency);
+        Serial.print("\t\t\t");
+        Serial.print((float)samplesPerBandwidth * 1000000.0f / (float)elapsed, 1);
+        Serial.print("\t\t");
+        Serial.println(failures);
+    }
+
+    delay(5000);
+}
@@ -0,0 +1,91 @@
+/*
+  Pipelined single-shot measurements over SPI from the MMC5983MA
+  By: SparkFun Electronics
+  Date: October 17th, 2026
+  License: SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+  https://www.sparkfun.com/products/19034
+
+  This example demonstrates the split-phase measurement API:
+    startMeasurement()   - triggers a measurement and returns immediately
+    isMeasurementReady() - cheap check, only touches the bus once the measurement time has elapsed
+    readFieldsXYZ()      - reads the result
+  The next measurement is started as soon as the previous one has been read, so the sensor
+  is kept busy while the code is free to do other work during each conversion.
+
+  Hardware Connections:
+  Connect CIPO to MISO, COPI to MOSI, and SCK to SCK, on an Arduino.
+  Connect CS to pin 4 on an Arduino.
+*/
+
+#include <SPI.h>
+
+#include <SparkFun_MMC5983MA_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_MMC5983MA
+
+SFE_MMC5983MA myMag;
+
+int csPin = 4;
+
+unsigned long sampleCount = 0;
+unsigned long otherWorkCount = 0;
+unsigned long lastReport = 0;
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println("MMC5983MA Example");
+
+    SPI.begin();
+
+    if (myMag.begin(csPin) == false)
+    {
+        Serial.println("MMC5983MA did not respond - check your wiring. Freezing.");
+        while (true)
+            ;
+    }
+
+    myMag.softReset();
+
+    Serial.println("MMC5983MA connected");
+
+    // Use the fastest filter bandwidth: 0.5ms per measurement
+    myMag.setFilterBandwidth(800);
+
+    // Start the first measurement
+    myMag.startMeasurement();
+    lastReport = millis();
+}
+
+void loop()
+{
+    if (myMag.isMeasurementReady())
+    {
+        uint32_t rawValueX = 0;
+        uint32_t rawValueY = 0;
+        uint32_t rawValueZ = 0;
+
+        myMag.readFieldsXYZ(&rawValueX, &rawValueY, &rawValueZ);
+
+        // Start the next measurement straight away
+        myMag.startMeasurement();
+
+        sampleCount++;
+    }
+    else
+    {
+        // The measurement is in progress. Do something useful here!
+        otherWorkCount++;
+    }
+
+    if (millis() - lastReport >= 1000)
+    {
+        Serial.print("Samples per second: ");
+        Serial.print(sampleCount);
+        Serial.print("\tLoop iterations spent on other work: ");
+        Serial.println(otherWorkCount);
+        sampleCount = 0;
+        otherWorkCount = 0;
+        lastReport = millis();
+    }
+}
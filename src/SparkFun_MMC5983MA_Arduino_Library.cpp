@@ -15,132 +15,10 @@
 #include "SparkFun_MMC5983MA_Arduino_Library.h"
 #include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
 
-bool SFE_MMC5983MA::setShadowBit(uint8_t registerAddress, const uint8_t bitMask, bool doWrite)
+bool SFE_MMC5983MA::writeShadowRegister(uint8_t registerIndex, uint8_t value)
 {
-    uint8_t *shadowRegister = nullptr;
-
-    // Which register are we referring to?
-    switch (registerAddress)
-    {
-    case INT_CTRL_0_REG:
-    {
-        shadowRegister = &memoryShadow.internalControl0;
-    }
-    break;
-
-    case INT_CTRL_1_REG:
-    {
-        shadowRegister = &memoryShadow.internalControl1;
-    }
-    break;
-
-    case INT_CTRL_2_REG:
-    {
-        shadowRegister = &memoryShadow.internalControl2;
-    }
-    break;
-
-    case INT_CTRL_3_REG:
-    {
-        shadowRegister = &memoryShadow.internalControl3;
-    }
-    break;
-
-    default:
-        break;
-    }
-
-    if (shadowRegister)
-    {
-        *shadowRegister |= bitMask;
-        if (doWrite)
-            return (mmc_io.writeSingleByte(registerAddress, *shadowRegister));
-        return true;
-    }
-
-    return false;
-}
-
-bool SFE_MMC5983MA::clearShadowBit(uint8_t registerAddress, const uint8_t bitMask, bool doWrite)
-{
-    uint8_t *shadowRegister = nullptr;
-
-    // Which register are we referring to?
-    switch (registerAddress)
-    {
-    case INT_CTRL_0_REG:
-    {
-        shadowRegister = &memoryShadow.internalControl0;
-    }
-    break;
-
-    case INT_CTRL_1_REG:
-    {
-        shadowRegister = &memoryShadow.internalControl1;
-    }
-    break;
-
-    case INT_CTRL_2_REG:
-    {
-        shadowRegister = &memoryShadow.internalControl2;
-    }
-    break;
-
-    case INT_CTRL_3_REG:
-    {
-        shadowRegister = &memoryShadow.internalControl3;
-    }
-    break;
-
-    default:
-        break;
-    }
-
-    if (shadowRegister)
-    {
-        *shadowRegister &= ~bitMask;
-        if (doWrite)
-            return (mmc_io.writeSingleByte(registerAddress, *shadowRegister));
-        return true;
-    }
-
-    return false;
-}
-
-bool SFE_MMC5983MA::isShadowBitSet(uint8_t registerAddress, const uint8_t bitMask)
-{
-    // Which register are we referring to?
-    switch (registerAddress)
-    {
-    case INT_CTRL_0_REG:
-    {
-        return (memoryShadow.internalControl0 & bitMask);
-    }
-    break;
-
-    case INT_CTRL_1_REG:
-    {
-        return (memoryShadow.internalControl1 & bitMask);
-    }
-    break;
-
-    case INT_CTRL_2_REG:
-    {
-        return (memoryShadow.internalControl2 & bitMask);
-    }
-    break;
-
-    case INT_CTRL_3_REG:
-    {
-        return (memoryShadow.internalControl3 & bitMask);
-    }
-    break;
-
-    default:
-        break;
-    }
-
-    return false;
+    SFE_MMC5983MA_TIME_CALL(SHADOW_REGISTER_WRITE);
+    return (mmc_io.writeSingleByte(INT_CTRL_0_REG + registerIndex, value));
 }
 
 void SFE_MMC5983MA::setErrorCallback(void (*_errorCallback)(SF_MMC5983MA_ERROR errorCode))
@@ -176,12 +54,25 @@ const char *SFE_MMC5983MA::errorCodeString(SF_MMC5983MA_ERROR errorCode)
   case SF_MMC5983MA_ERROR::INVALID_PERIODIC_SAMPLES:
     return "INVALID_PERIODIC_SAMPLES";
     break;
+  case SF_MMC5983MA_ERROR::BUS_INITIALIZATION_ERROR:
+    return "BUS_INITIALIZATION_ERROR";
+    break;
+  case SF_MMC5983MA_ERROR::INVALID_PROFILE:
+    return "INVALID_PROFILE";
+    break;
+  case SF_MMC5983MA_ERROR::DATA_RATE_TOO_LOW:
+    return "DATA_RATE_TOO_LOW";
+    break;
+  case SF_MMC5983MA_ERROR::DATA_STALLED:
+    return "DATA_STALLED";
+    break;
   default:
     return "UNDEFINED";
     break;
   }
 };
 
+#ifdef SFE_MMC5983MA_USE_I2C
 bool SFE_MMC5983MA::begin(TwoWire &wirePort)
 {
     // Initializes I2C and check if device responds
@@ -192,9 +83,18 @@ bool SFE_MMC5983MA::begin(TwoWire &wirePort)
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::I2C_INITIALIZATION_ERROR);
         return false;
     }
-    return isConnected();
+
+    // The IO layer has already checked the product ID
+    return true;
 }
 
+void SFE_MMC5983MA::setI2CRepeatedStart(bool enable)
+{
+    mmc_io.setI2CRepeatedStart(enable);
+}
+#endif
+
+#ifdef SFE_MMC5983MA_USE_SPI
 bool SFE_MMC5983MA::begin(uint8_t userCSPin, SPIClass &spiPort)
 {
     bool success = mmc_io.begin(userCSPin, spiPort);
@@ -203,7 +103,9 @@ bool SFE_MMC5983MA::begin(uint8_t userCSPin, SPIClass &spiPort)
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::SPI_INITIALIZATION_ERROR);
         return false;
     }
-    return isConnected();
+
+    // The IO layer has already checked the product ID
+    return true;
 }
 
 bool SFE_MMC5983MA::begin(uint8_t userCSPin, SPISettings userSettings, SPIClass &spiPort)
@@ -214,8 +116,36 @@ bool SFE_MMC5983MA::begin(uint8_t userCSPin, SPISettings userSettings, SPIClass
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::SPI_INITIALIZATION_ERROR);
         return false;
     }
-    return isConnected();
+
+    // The IO layer has already checked the product ID
+    return true;
+}
+
+void SFE_MMC5983MA::beginSPITransaction(bool ownTransaction)
+{
+    mmc_io.holdSPITransaction(ownTransaction);
+}
+
+void SFE_MMC5983MA::endSPITransaction()
+{
+    mmc_io.releaseSPITransaction();
+}
+#endif
+
+#ifdef SFE_MMC5983MA_USE_BUS
+bool SFE_MMC5983MA::begin(SFE_MMC5983MA_Bus &bus)
+{
+    bool success = mmc_io.begin(bus);
+    if (!success)
+    {
+        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_INITIALIZATION_ERROR);
+        return false;
+    }
+
+    // The IO layer has already checked the product ID
+    return true;
 }
+#endif
 
 bool SFE_MMC5983MA::isConnected()
 {
@@ -238,132 +168,189 @@ bool SFE_MMC5983MA::isConnected()
 
 int SFE_MMC5983MA::getTemperature()
 {
-    // Set the TM_T bit to start the temperature conversion.
-    // Do this using the shadow register. If we do it with setRegisterBit
-    // (read-modify-write) we end up setting the Auto_SR_en bit too as that
-    // always seems to read as 1...? I don't know why.
-    if (!setShadowBit(INT_CTRL_0_REG, TM_T))
-    {
-        clearShadowBit(INT_CTRL_0_REG, TM_T, false); // Clear the bit - in shadow memory only
-        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+    uint8_t result = 0;
+    if (!getTemperatureRaw(&result))
         return -99;
-    }
 
-    // Wait until measurement is completed.
-    // It is rare but there are some devices and some circumstances where the code can become
-    // stuck in this loop waiting for MEAS_T_DONE to go high. The solution is to timeout after 5ms.
-    uint8_t timeOut = 5;
-    do
-    {
-        // Wait a little so we won't flood MMC with requests
-        delay(1);
-        timeOut--;
-    } while ((!mmc_io.isBitSet(STATUS_REG, MEAS_T_DONE)) && (timeOut > 0));
+    // Convert it using the equation provided in the datasheet
+    float temperature = -75.0f + (static_cast<float>(result) * (200.0f / 255.0f));
+
+    // Return the integer part of the temperature.
+    return static_cast<int>(temperature);
+}
+
+bool SFE_MMC5983MA::getTemperatureRaw(uint8_t *rawTemperature)
+{
+    SFE_MMC5983MA_TIME_CALL(GET_TEMPERATURE);
+
+    // Start the temperature conversion. This raises its own errors.
+    if (!startTemperatureMeasurement())
+        return false;
 
-    clearShadowBit(INT_CTRL_0_REG, TM_T, false); // Clear the bit - in shadow memory only
+    // Wait until measurement is completed. The temperature conversion takes as long as a magnetic one.
+    // It is rare but there are some devices and some circumstances where the code can become
+    // stuck in this loop waiting for MEAS_T_DONE to go high, so use the measurement timeout too.
+    waitForMeasurement(MEAS_T_DONE, temperatureStartMicros, getMeasurementTime(), getMeasurementTimeout());
 
     // Get raw temperature value from the IC
     // even if a timeout occurred - old data vs no data
-    uint8_t result = 0;
-    if (!mmc_io.readSingleByte(T_OUT_REG, &result))
+    if (!mmc_io.readSingleByte(T_OUT_REG, rawTemperature))
     {
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
-        return -99;
+        return false;
     }
 
-    // Convert it using the equation provided in the datasheet
-    float temperature = -75.0f + (static_cast<float>(result) * (200.0f / 255.0f));
-
-    // Return the integer part of the temperature.
-    return static_cast<int>(temperature);
+    return true;
 }
 
 bool SFE_MMC5983MA::softReset()
 {
+    SFE_MMC5983MA_TIME_CALL(SOFT_RESET);
+
     // Set the SW_RST bit to perform a software reset.
     // Do this using the shadow register. If we do it with setRegisterBit
     // (read-modify-write) we end up setting the reserved and BW_0 bits too as they
     // always seems to read as 1...? I don't know why.
-    bool success = setShadowBit(INT_CTRL_1_REG, SW_RST);
+    bool success = writeCommand<SFE_MMC5983MA_Fields::SwRst>();
 
-    clearShadowBit(INT_CTRL_1_REG, SW_RST, false); // Clear the bit - in shadow memory only
+    // The reset clears all the control registers, and stops any conversion
+    for (uint8_t i = 0; i < SFE_MMC5983MA_SHADOW_REGISTERS; i++)
+        memoryShadow[i] = 0;
+    measurementPending = false;
+    temperaturePending = false;
 
-    // The reset time is 10 msec. but we'll wait 15 msec. just in case.
-    delay(15);
+    // The reset time is 10 msec. Poll for the end of it, for up to 15 msec. just in case.
+    return (success && waitForOTPReadDone(true));
+}
 
-    return success;
+bool SFE_MMC5983MA::waitForOTPReadDone(bool afterReset)
+{
+    uint32_t startMicros = mmc_io.getMicros();
+
+    // A stale OTP_READ_DONE from before a reset must not end the wait early
+    bool seenClear = !afterReset;
+
+    while (true)
+    {
+        // Back off first, so the status is not read before the reset has started
+        mmc_io.waitMicros(pollIntervalMicros);
+
+        // The device may not answer while it is reading its OTP memory,
+        // so a failed read only means it is not ready yet
+        uint8_t status = 0;
+        bool answered = mmc_io.readSingleByte(STATUS_REG, &status);
+        uint32_t elapsed = mmc_io.getMicros() - startMicros;
+
+        if (answered)
+        {
+            if ((status & OTP_READ_DONE) == 0)
+                seenClear = true;
+            else if (seenClear || (elapsed >= OTP_READ_MICROS))
+                return true;
+        }
+
+        if (elapsed >= OTP_READ_TIMEOUT_MICROS)
+        {
+#ifdef SFE_MMC5983MA_ENABLE_STATS
+            mmc_io.recordTimeout();
+#endif
+            return false;
+        }
+    }
+}
+
+bool SFE_MMC5983MA::fastStart(const SFE_MMC5983MA_Profile &profile, bool reset)
+{
+    // Warm start: reset the device and wait for it. Cold start: the device has just
+    // been powered, so only wait for it to finish reading its OTP memory.
+    bool ready = reset ? softReset() : waitForOTPReadDone(false);
+
+    if (!ready)
+    {
+        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+        return false;
+    }
+
+    // The power-on and reset values of the control registers are all zero
+    if (!reset)
+    {
+        for (uint8_t i = 0; i < SFE_MMC5983MA_SHADOW_REGISTERS; i++)
+            memoryShadow[i] = 0;
+    }
+
+    return applyProfile(profile);
 }
 
 bool SFE_MMC5983MA::enableInterrupt()
 {
     // This bit must be set through the shadow memory or we won't be
     // able to check if interrupts are enabled using isInterruptEnabled()
-    return (setShadowBit(INT_CTRL_0_REG, INT_MEAS_DONE_EN));
+    return (setShadowField<SFE_MMC5983MA_Fields::IntMeasDoneEn>());
 }
 
 bool SFE_MMC5983MA::disableInterrupt()
 {
     // This bit must be cleared through the shadow memory or we won't be
     // able to check if interrupts are enabled using isInterruptEnabled()
-    return (clearShadowBit(INT_CTRL_0_REG, INT_MEAS_DONE_EN));
+    return (clearShadowField<SFE_MMC5983MA_Fields::IntMeasDoneEn>());
 }
 
 bool SFE_MMC5983MA::isInterruptEnabled()
 {
     // Get the bit value from the shadow register since the IC does not
     // allow reading INT_CTRL_0_REG register.
-    return isShadowBitSet(INT_CTRL_0_REG, INT_MEAS_DONE_EN);
+    return isShadowFieldSet<SFE_MMC5983MA_Fields::IntMeasDoneEn>();
 }
 
 bool SFE_MMC5983MA::enable3WireSPI()
 {
     // This bit must be set through the shadow memory or we won't be
     // able to check if SPI is enabled using isSPIEnabled()
-    return (setShadowBit(INT_CTRL_3_REG, SPI_3W));
+    return (setShadowField<SFE_MMC5983MA_Fields::Spi3W>());
 }
 
 bool SFE_MMC5983MA::disable3WireSPI()
 {
     // This bit must be cleared through the shadow memory or we won't be
     // able to check if is is enabled using isSPIEnabled()
-    return (clearShadowBit(INT_CTRL_3_REG, SPI_3W));
+    return (clearShadowField<SFE_MMC5983MA_Fields::Spi3W>());
 }
 
 bool SFE_MMC5983MA::is3WireSPIEnabled()
 {
     // Get the bit value from the shadow register since the IC does not
     // allow reading INT_CTRL_3_REG register.
-    return (isShadowBitSet(INT_CTRL_3_REG, SPI_3W));
+    return (isShadowFieldSet<SFE_MMC5983MA_Fields::Spi3W>());
 }
 
-bool SFE_MMC5983MA::performSetOperation()
+bool SFE_MMC5983MA::performSetOperation(uint16_t settleMicros)
 {
+    SFE_MMC5983MA_TIME_CALL(SET_RESET_OPERATION);
+
     // Set the SET bit to perform a set operation.
     // Do this using the shadow register. If we do it with setRegisterBit
     // (read-modify-write) we end up setting the Auto_SR_en bit too as that
     // always seems to read as 1...? I don't know why.
-    bool success = setShadowBit(INT_CTRL_0_REG, SET_OPERATION);
-
-    clearShadowBit(INT_CTRL_0_REG, SET_OPERATION, false); // Clear the bit - in shadow memory only
+    bool success = writeCommand<SFE_MMC5983MA_Fields::Set>();
 
     // Wait for the set operation to complete (500ns).
-    delay(1);
+    mmc_io.waitMicros(settleMicros);
 
     return success;
 }
 
-bool SFE_MMC5983MA::performResetOperation()
+bool SFE_MMC5983MA::performResetOperation(uint16_t settleMicros)
 {
+    SFE_MMC5983MA_TIME_CALL(SET_RESET_OPERATION);
+
     // Set the RESET bit to perform a reset operation.
     // Do this using the shadow register. If we do it with setRegisterBit
     // (read-modify-write) we end up setting the Auto_SR_en bit too as that
     // always seems to read as 1...? I don't know why.
-    bool success = setShadowBit(INT_CTRL_0_REG, RESET_OPERATION);
-
-    clearShadowBit(INT_CTRL_0_REG, RESET_OPERATION, false); // Clear the bit - in shadow memory only
+    bool success = writeCommand<SFE_MMC5983MA_Fields::Reset>();
 
     // Wait for the reset operation to complete (500ns).
-    delay(1);
+    mmc_io.waitMicros(settleMicros);
 
     return success;
 }
@@ -372,21 +359,21 @@ bool SFE_MMC5983MA::enableAutomaticSetReset()
 {
     // This bit must be set through the shadow memory or we won't be
     // able to check if automatic set/reset is enabled using isAutomaticSetResetEnabled()
-    return (setShadowBit(INT_CTRL_0_REG, AUTO_SR_EN));
+    return (setShadowField<SFE_MMC5983MA_Fields::AutoSrEn>());
 }
 
 bool SFE_MMC5983MA::disableAutomaticSetReset()
 {
     // This bit must be cleared through the shadow memory or we won't be
     // able to check if automatic set/reset is enabled using isAutomaticSetResetEnabled()
-    return (clearShadowBit(INT_CTRL_0_REG, AUTO_SR_EN));
+    return (clearShadowField<SFE_MMC5983MA_Fields::AutoSrEn>());
 }
 
 bool SFE_MMC5983MA::isAutomaticSetResetEnabled()
 {
     // Get the bit value from the shadow register since the IC does not
     // allow reading INT_CTRL_0_REG register.
-    return (isShadowBitSet(INT_CTRL_0_REG, AUTO_SR_EN));
+    return (isShadowFieldSet<SFE_MMC5983MA_Fields::AutoSrEn>());
 }
 
 bool SFE_MMC5983MA::enableXChannel()
@@ -395,7 +382,7 @@ bool SFE_MMC5983MA::enableXChannel()
     // able to check if the channel is enabled using isXChannelEnabled()
     // and since it's a inhibit bit it must be cleared so X channel will
     // be enabled.
-    return (clearShadowBit(INT_CTRL_1_REG, X_INHIBIT));
+    return (clearShadowField<SFE_MMC5983MA_Fields::XInhibit>());
 }
 
 bool SFE_MMC5983MA::disableXChannel()
@@ -404,7 +391,7 @@ bool SFE_MMC5983MA::disableXChannel()
     // able to check if the channel is enabled using isXChannelEnabled()
     // and since it's a inhibit bit it must be set so X channel will
     // be disabled.
-    return (setShadowBit(INT_CTRL_1_REG, X_INHIBIT));
+    return (setShadowField<SFE_MMC5983MA_Fields::XInhibit>());
 }
 
 bool SFE_MMC5983MA::isXChannelEnabled()
@@ -414,7 +401,7 @@ bool SFE_MMC5983MA::isXChannelEnabled()
     //
     // Note: this returns true when the X channel is inhibited.
     // Strictly, it should be called isXChannelInhibited.
-    return (isShadowBitSet(INT_CTRL_1_REG, X_INHIBIT));
+    return (isShadowFieldSet<SFE_MMC5983MA_Fields::XInhibit>());
 }
 
 bool SFE_MMC5983MA::enableYZChannels()
@@ -423,7 +410,7 @@ bool SFE_MMC5983MA::enableYZChannels()
     // able to check if channels are enabled using areYZChannelsEnabled()
     // and since it's a inhibit bit it must be cleared so X channel will
     // be enabled.
-    return (clearShadowBit(INT_CTRL_1_REG, YZ_INHIBIT));
+    return (clearShadowField<SFE_MMC5983MA_Fields::YzInhibit>());
 }
 
 bool SFE_MMC5983MA::disableYZChannels()
@@ -432,7 +419,7 @@ bool SFE_MMC5983MA::disableYZChannels()
     // able to check if channels are enabled using areYZChannelsEnabled()
     // and since it's a inhibit bit it must be cleared so X channel will
     // be disabled.
-    return (setShadowBit(INT_CTRL_1_REG, YZ_INHIBIT));
+    return (setShadowField<SFE_MMC5983MA_Fields::YzInhibit>());
 }
 
 bool SFE_MMC5983MA::areYZChannelsEnabled()
@@ -442,62 +429,46 @@ bool SFE_MMC5983MA::areYZChannelsEnabled()
     //
     // Note: this returns true when the Y and Z channels are inhibited.
     // Strictly, it should be called areYZChannelsInhibited.
-    return (isShadowBitSet(INT_CTRL_1_REG, YZ_INHIBIT));
+    return (isShadowFieldSet<SFE_MMC5983MA_Fields::YzInhibit>());
 }
 
 bool SFE_MMC5983MA::setFilterBandwidth(uint16_t bandwidth)
 {
     // These must be set/cleared using the shadow memory since it can be read
     // using getFilterBandwidth()
-    bool success;
+    uint8_t value;
 
     switch (bandwidth)
     {
     case 800:
-    {
-        success = setShadowBit(INT_CTRL_1_REG, BW0, false);
-        success &= setShadowBit(INT_CTRL_1_REG, BW1);
-    }
-    break;
+        value = 3; // BW[1:0] = 11
+        break;
 
     case 400:
-    {
-        success = clearShadowBit(INT_CTRL_1_REG, BW0, false);
-        success &= setShadowBit(INT_CTRL_1_REG, BW1);
-    }
-    break;
+        value = 2; // BW[1:0] = 10
+        break;
 
     case 200:
-    {
-        success = setShadowBit(INT_CTRL_1_REG, BW0, false);
-        success &= clearShadowBit(INT_CTRL_1_REG, BW1);
-    }
-    break;
+        value = 1; // BW[1:0] = 01
+        break;
 
     case 100:
-    {
-        success = clearShadowBit(INT_CTRL_1_REG, BW0, false);
-        success &= clearShadowBit(INT_CTRL_1_REG, BW1);
-    }
-    break;
+        value = 0; // BW[1:0] = 00
+        break;
 
     default:
     {
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::INVALID_FILTER_BANDWIDTH);
-        success = false;
+        return false;
     }
-    break;
     }
 
-    return success;
+    return writeShadowField<SFE_MMC5983MA_Fields::Bw>(value);
 }
 
 uint16_t SFE_MMC5983MA::getFilterBandwidth()
 {
-    bool bw0 = isShadowBitSet(INT_CTRL_1_REG, BW0);
-    bool bw1 = isShadowBitSet(INT_CTRL_1_REG, BW1);
-
-    uint8_t value = (bw1 ? 2 : 0) + (bw0 ? 1 : 0);
+    uint8_t value = readShadowField<SFE_MMC5983MA_Fields::Bw>();
     uint16_t retVal = 0;
     switch (value)
     {
@@ -522,130 +493,157 @@ uint16_t SFE_MMC5983MA::getFilterBandwidth()
     return retVal;
 }
 
-uint16_t SFE_MMC5983MA::getTimeout()
+uint32_t SFE_MMC5983MA::getMeasurementTime()
+{
+    // Measurement time for each BW1/0 setting, from the datasheet.
+    switch (getFilterBandwidth())
+    {
+    case 800:
+        return 500;
+
+    case 400:
+        return 2000;
+
+    case 200:
+        return 4000;
+
+    case 100:
+    default:
+        return 8000;
+    }
+}
+
+uint32_t SFE_MMC5983MA::getMeasurementTimeout()
 {
     // It is rare but there are some devices and some circumstances where the code can become
     // stuck in the getMeasurement loop waiting for the MEAS_M_DONE bit to go high.
     // We have seen this on SPI where the MMC5983 is sharing the bus with (e.g.) an ISM330 IMU
     // which uses a different SPI mode.
-    // A solution is to timeout after 4 * the measurement time (defined by BW1/0).
-    uint16_t timeOut = getFilterBandwidth(); // Read the bandwidth (100/200/400/800Hz) from shadow
-    timeOut = 800 / timeOut; // Convert timeOut to 8/4/2/1ms
-    timeOut *= 4; // Convert bw to 32/16/8/4ms
-    timeOut += 1; // Add 1 just in case (for 800Hz)
-    return timeOut;
+    // A solution is to timeout after 4 * the measurement time (defined by BW1/0), plus a margin.
+    return (getMeasurementTime() * timeoutMultiplier) + timeoutMarginMicros;
+}
+
+void SFE_MMC5983MA::setMeasurementTimeout(uint8_t multiplier, uint16_t marginMicros)
+{
+    timeoutMultiplier = multiplier;
+    timeoutMarginMicros = marginMicros;
+}
+
+void SFE_MMC5983MA::setPollInterval(uint16_t intervalMicros)
+{
+    pollIntervalMicros = intervalMicros;
+}
+
+bool SFE_MMC5983MA::waitForMeasurement(uint8_t doneMask, uint32_t startMicros, uint32_t expectedMicros, uint32_t timeoutMicros)
+{
+    // There is no point polling the status register before the conversion can have finished
+    uint32_t elapsed = mmc_io.getMicros() - startMicros;
+    if (elapsed < expectedMicros)
+        mmc_io.waitMicros(expectedMicros - elapsed);
+
+    while (!mmc_io.isBitSet(STATUS_REG, doneMask))
+    {
+        if ((mmc_io.getMicros() - startMicros) >= timeoutMicros)
+        {
+#ifdef SFE_MMC5983MA_ENABLE_STATS
+            mmc_io.recordTimeout();
+#endif
+            return false;
+        }
+
+        // Back off a little so we won't flood MMC with requests
+        mmc_io.waitMicros(pollIntervalMicros);
+    }
+
+    if (doneMask & MEAS_M_DONE)
+        measurementPending = false;
+    if (doneMask & MEAS_T_DONE)
+        temperaturePending = false;
+
+    return true;
+}
+
+void SFE_MMC5983MA::waitForConversion(bool *pending, uint32_t startMicros)
+{
+    if (!*pending)
+        return;
+
+    uint32_t elapsed = mmc_io.getMicros() - startMicros;
+    if (elapsed < getMeasurementTime())
+        mmc_io.waitMicros(getMeasurementTime() - elapsed);
+
+    *pending = false;
 }
 
 bool SFE_MMC5983MA::enableContinuousMode()
 {
     // This bit must be set through the shadow memory or we won't be
     // able to check if continuous mode is enabled using isContinuousModeEnabled()
-    return (setShadowBit(INT_CTRL_2_REG, CMM_EN));
+    return (setShadowField<SFE_MMC5983MA_Fields::CmmEn>());
 }
 
 bool SFE_MMC5983MA::disableContinuousMode()
 {
     // This bit must be cleared through the shadow memory or we won't be
     // able to check if continuous mode is enabled using isContinuousModeEnabled()
-    return (clearShadowBit(INT_CTRL_2_REG, CMM_EN));
+    return (clearShadowField<SFE_MMC5983MA_Fields::CmmEn>());
 }
 
 bool SFE_MMC5983MA::isContinuousModeEnabled()
 {
     // Get the bit value from the shadow register since the IC does not
     // allow reading INT_CTRL_2_REG register.
-    return (isShadowBitSet(INT_CTRL_2_REG, CMM_EN));
+    return (isShadowFieldSet<SFE_MMC5983MA_Fields::CmmEn>());
 }
 
 bool SFE_MMC5983MA::setContinuousModeFrequency(uint16_t frequency)
 {
     // These must be set/cleared using the shadow memory since it can be read
     // using getContinuousModeFrequency()
-    bool success;
+    uint8_t value;
 
     switch (frequency)
     {
     case 1:
-    {
-        // CM_FREQ[2:0] = 001
-        success = clearShadowBit(INT_CTRL_2_REG, CM_FREQ_2, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, CM_FREQ_1, false);
-        success &= setShadowBit(INT_CTRL_2_REG, CM_FREQ_0);
-    }
-    break;
+        value = 1; // CM_FREQ[2:0] = 001
+        break;
 
     case 10:
-    {
-        // CM_FREQ[2:0] = 010
-        success = clearShadowBit(INT_CTRL_2_REG, CM_FREQ_2, false);
-        success &= setShadowBit(INT_CTRL_2_REG, CM_FREQ_1, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, CM_FREQ_0);
-    }
-    break;
+        value = 2; // CM_FREQ[2:0] = 010
+        break;
 
     case 20:
-    {
-        // CM_FREQ[2:0] = 011
-        success = clearShadowBit(INT_CTRL_2_REG, CM_FREQ_2, false);
-        success &= setShadowBit(INT_CTRL_2_REG, CM_FREQ_1, false);
-        success &= setShadowBit(INT_CTRL_2_REG, CM_FREQ_0);
-    }
-    break;
+        value = 3; // CM_FREQ[2:0] = 011
+        break;
 
     case 50:
-    {
-        // CM_FREQ[2:0] = 100
-        success = setShadowBit(INT_CTRL_2_REG, CM_FREQ_2, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, CM_FREQ_1, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, CM_FREQ_0);
-    }
-    break;
+        value = 4; // CM_FREQ[2:0] = 100
+        break;
 
     case 100:
-    {
-        // CM_FREQ[2:0] = 101
-        success = setShadowBit(INT_CTRL_2_REG, CM_FREQ_2, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, CM_FREQ_1, false);
-        success &= setShadowBit(INT_CTRL_2_REG, CM_FREQ_0);
-    }
-    break;
+        value = 5; // CM_FREQ[2:0] = 101
+        break;
 
     case 200:
-    {
-        // CM_FREQ[2:0] = 110
-        success = setShadowBit(INT_CTRL_2_REG, CM_FREQ_2, false);
-        success &= setShadowBit(INT_CTRL_2_REG, CM_FREQ_1, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, CM_FREQ_0);
-    }
-    break;
+        value = 6; // CM_FREQ[2:0] = 110
+        break;
 
     case 1000:
-    {
-        // CM_FREQ[2:0] = 111
-        success = setShadowBit(INT_CTRL_2_REG, CM_FREQ_2, false);
-        success &= setShadowBit(INT_CTRL_2_REG, CM_FREQ_1, false);
-        success &= setShadowBit(INT_CTRL_2_REG, CM_FREQ_0);
-    }
-    break;
+        value = 7; // CM_FREQ[2:0] = 111
+        break;
 
     case 0:
-    {
-        // CM_FREQ[2:0] = 000
-        success = clearShadowBit(INT_CTRL_2_REG, CM_FREQ_2, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, CM_FREQ_1, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, CM_FREQ_0);
-    }
-    break;
+        value = 0; // CM_FREQ[2:0] = 000
+        break;
 
     default:
     {
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::INVALID_CONTINUOUS_FREQUENCY);
-        success = false;
+        return false;
     }
-    break;
     }
 
-    return success;
+    return writeShadowField<SFE_MMC5983MA_Fields::CmFreq>(value);
 }
 
 uint16_t SFE_MMC5983MA::getContinuousModeFrequency()
@@ -653,8 +651,7 @@ uint16_t SFE_MMC5983MA::getContinuousModeFrequency()
     // Since we cannot read INT_CTRL_2_REG we evaluate the shadow
     // memory contents and return the corresponding frequency.
 
-    // Remove unwanted bits
-    uint8_t registerValue = memoryShadow.internalControl2 & 0x07;
+    uint8_t registerValue = readShadowField<SFE_MMC5983MA_Fields::CmFreq>();
     uint16_t frequency = 0;
 
     switch (registerValue)
@@ -713,113 +710,71 @@ bool SFE_MMC5983MA::enablePeriodicSet()
 {
     // This bit must be set through the shadow memory or we won't be
     // able to check if periodic set is enabled using isContinuousModeEnabled()
-    return (setShadowBit(INT_CTRL_2_REG, EN_PRD_SET));
+    return (setShadowField<SFE_MMC5983MA_Fields::EnPrdSet>());
 }
 
 bool SFE_MMC5983MA::disablePeriodicSet()
 {
     // This bit must be cleared through the shadow memory or we won't be
     // able to check if periodic set is enabled using isContinuousModeEnabled()
-    return (clearShadowBit(INT_CTRL_2_REG, EN_PRD_SET));
+    return (clearShadowField<SFE_MMC5983MA_Fields::EnPrdSet>());
 }
 
 bool SFE_MMC5983MA::isPeriodicSetEnabled()
 {
     // Get the bit value from the shadow register since the IC does not
     // allow reading INT_CTRL_2_REG register.
-    return (isShadowBitSet(INT_CTRL_2_REG, EN_PRD_SET));
+    return (isShadowFieldSet<SFE_MMC5983MA_Fields::EnPrdSet>());
 }
 
 bool SFE_MMC5983MA::setPeriodicSetSamples(const uint16_t numberOfSamples)
 {
-    // We must use the shadow memory to do all bits manipulations but
-    // we need to access the shadow memory directly, change bits and
-    // write back at once.
-    bool success;
-    
+    // These must be set/cleared using the shadow memory since it can be read
+    // using getPeriodicSetSamples()
+    uint8_t value;
+
     switch (numberOfSamples)
     {
     case 25:
-    {
-        // PRD_SET[2:0] = 001
-        success = clearShadowBit(INT_CTRL_2_REG, PRD_SET_2, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, PRD_SET_1, false);
-        success &= setShadowBit(INT_CTRL_2_REG, PRD_SET_0);
-    }
-    break;
+        value = 1; // PRD_SET[2:0] = 001
+        break;
 
     case 75:
-    {
-        // PRD_SET[2:0] = 010
-        success = clearShadowBit(INT_CTRL_2_REG, PRD_SET_2, false);
-        success &= setShadowBit(INT_CTRL_2_REG, PRD_SET_1, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, PRD_SET_0);
-    }
-    break;
+        value = 2; // PRD_SET[2:0] = 010
+        break;
 
     case 100:
-    {
-        // PRD_SET[2:0] = 011
-        success = clearShadowBit(INT_CTRL_2_REG, PRD_SET_2, false);
-        success &= setShadowBit(INT_CTRL_2_REG, PRD_SET_1, false);
-        success &= setShadowBit(INT_CTRL_2_REG, PRD_SET_0);
-    }
-    break;
+        value = 3; // PRD_SET[2:0] = 011
+        break;
 
     case 250:
-    {
-        // PRD_SET[2:0] = 100
-        success = setShadowBit(INT_CTRL_2_REG, PRD_SET_2, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, PRD_SET_1, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, PRD_SET_0);
-    }
-    break;
+        value = 4; // PRD_SET[2:0] = 100
+        break;
 
     case 500:
-    {
-        // PRD_SET[2:0] = 101
-        success = setShadowBit(INT_CTRL_2_REG, PRD_SET_2, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, PRD_SET_1, false);
-        success &= setShadowBit(INT_CTRL_2_REG, PRD_SET_0);
-    }
-    break;
+        value = 5; // PRD_SET[2:0] = 101
+        break;
 
     case 1000:
-    {
-        // PRD_SET[2:0] = 110
-        success = setShadowBit(INT_CTRL_2_REG, PRD_SET_2, false);
-        success &= setShadowBit(INT_CTRL_2_REG, PRD_SET_1, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, PRD_SET_0);
-    }
-    break;
+        value = 6; // PRD_SET[2:0] = 110
+        break;
 
     case 2000:
-    {
-        // PRD_SET[2:0] = 111
-        success = setShadowBit(INT_CTRL_2_REG, PRD_SET_2, false);
-        success &= setShadowBit(INT_CTRL_2_REG, PRD_SET_1, false);
-        success &= setShadowBit(INT_CTRL_2_REG, PRD_SET_0);
-    }
-    break;
+        value = 7; // PRD_SET[2:0] = 111
+        break;
 
     case 1:
-    {
-        // PRD_SET[2:0] = 000
-        success = clearShadowBit(INT_CTRL_2_REG, PRD_SET_2, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, PRD_SET_1, false);
-        success &= clearShadowBit(INT_CTRL_2_REG, PRD_SET_0);
-    }
-    break;
+        value = 0; // PRD_SET[2:0] = 000
+        break;
 
     default:
     {
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::INVALID_PERIODIC_SAMPLES);
-        success = false;
+        return false;
     }
-    break;
     }
 
-    return success;
+    return writeShadowField<SFE_MMC5983MA_Fields::PrdSet>(value);
 }
 
 uint16_t SFE_MMC5983MA::getPeriodicSetSamples()
@@ -828,49 +783,48 @@ uint16_t SFE_MMC5983MA::getPeriodicSetSamples()
     // Since we cannot read INT_CTRL_2_REG we evaluate the shadow
     // memory contents and return the corresponding period.
 
-    // Remove unwanted bits
-    uint8_t registerValue = memoryShadow.internalControl2 & 0x70;
+    uint8_t registerValue = readShadowField<SFE_MMC5983MA_Fields::PrdSet>();
     uint16_t period = 1;
 
     switch (registerValue)
     {
-    case 0x10:
+    case 0x01:
     {
         period = 25;
     }
     break;
 
-    case 0x20:
+    case 0x02:
     {
         period = 75;
     }
     break;
 
-    case 0x30:
+    case 0x03:
     {
         period = 100;
     }
     break;
 
-    case 0x40:
+    case 0x04:
     {
         period = 250;
     }
     break;
 
-    case 0x50:
+    case 0x05:
     {
         period = 500;
     }
     break;
 
-    case 0x60:
+    case 0x06:
     {
         period = 1000;
     }
     break;
 
-    case 0x70:
+    case 0x07:
     {
         period = 2000;
     }
@@ -888,67 +842,85 @@ bool SFE_MMC5983MA::applyExtraCurrentPosToNeg()
 {
     // This bit must be set through the shadow memory or we won't be
     // able to check if extra current is applied using isExtraCurrentAppliedPosToNeg()
-    return (setShadowBit(INT_CTRL_3_REG, ST_ENP));
+    return (setShadowField<SFE_MMC5983MA_Fields::StEnp>());
 }
 
 bool SFE_MMC5983MA::removeExtraCurrentPosToNeg()
 {
     // This bit must be cleared through the shadow memory or we won't be
     // able to check if extra current is applied using isExtraCurrentAppliedPosToNeg()
-    return (clearShadowBit(INT_CTRL_3_REG, ST_ENP));
+    return (clearShadowField<SFE_MMC5983MA_Fields::StEnp>());
 }
 
 bool SFE_MMC5983MA::isExtraCurrentAppliedPosToNeg()
 {
     // Get the bit value from the shadow register since the IC does not
     // allow reading INT_CTRL_3_REG register.
-    return (isShadowBitSet(INT_CTRL_3_REG, ST_ENP));
+    return (isShadowFieldSet<SFE_MMC5983MA_Fields::StEnp>());
 }
 
 bool SFE_MMC5983MA::applyExtracurrentNegToPos()
 {
     // This bit must be set through the shadow memory or we won't be
     // able to check if extra current is applied using isExtraCurrentAppliedNegToPos()
-    return (setShadowBit(INT_CTRL_3_REG, ST_ENM));
+    return (setShadowField<SFE_MMC5983MA_Fields::StEnm>());
 }
 
 bool SFE_MMC5983MA::removeExtracurrentNegToPos()
 {
     // This bit must be cleared through the shadow memory or we won't be
     // able to check if extra current is applied using isExtraCurrentAppliedNegToPos()
-    return (clearShadowBit(INT_CTRL_3_REG, ST_ENM));
+    return (clearShadowField<SFE_MMC5983MA_Fields::StEnm>());
 }
 
 bool SFE_MMC5983MA::isExtraCurrentAppliedNegToPos()
 {
     // Get the bit value from the shadow register since the IC does not
     // allow reading INT_CTRL_3_REG register.
-    return (isShadowBitSet(INT_CTRL_3_REG, ST_ENM));
+    return (isShadowFieldSet<SFE_MMC5983MA_Fields::StEnm>());
 }
 
-uint32_t SFE_MMC5983MA::getMeasurementX()
+bool SFE_MMC5983MA::applyProfile(const SFE_MMC5983MA_Profile &profile)
 {
-    // Set the TM_M bit to start the measurement.
-    // Do this using the shadow register. If we do it with setRegisterBit
-    // (read-modify-write) we end up setting the Auto_SR_en bit too as that
-    // always seems to read as 1...? I don't know why.
-    if (!setShadowBit(INT_CTRL_0_REG, TM_M))
+    SFE_MMC5983MA_TIME_CALL(APPLY_PROFILE);
+
+    if (!profile.isValid())
     {
-        clearShadowBit(INT_CTRL_0_REG, TM_M, false); // Clear the bit - in shadow memory only
+        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::INVALID_PROFILE);
+        return false;
+    }
+
+    uint8_t registerValues[4];
+    for (uint8_t i = 0; i < 4; i++)
+        registerValues[i] = profile.getRegister(i);
+
+    // INT_CTRL_0_REG to INT_CTRL_3_REG are consecutive, so this is a single write.
+    // The bandwidth (INT_CTRL_1_REG) lands before continuous mode is enabled (INT_CTRL_2_REG).
+    bool success = mmc_io.writeMultipleBytes(INT_CTRL_0_REG, registerValues, 4);
+
+    for (uint8_t i = 0; i < SFE_MMC5983MA_SHADOW_REGISTERS; i++)
+        memoryShadow[i] = registerValues[i];
+
+    if (!success)
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+
+    return success;
+}
+
+SFE_MMC5983MA_Profile SFE_MMC5983MA::getProfile()
+{
+    return SFE_MMC5983MA_Profile::fromRegisters(memoryShadow[0], memoryShadow[1], memoryShadow[2], memoryShadow[3]);
+}
+
+uint32_t SFE_MMC5983MA::getMeasurementX()
+{
+    SFE_MMC5983MA_TIME_CALL(GET_MEASUREMENT_AXIS);
+
+    if (!startMeasurement())
         return 0;
-    }
 
     // Wait until measurement is completed or times out
-    uint16_t timeOut = getTimeout();
-    do
-    {
-        // Wait a little so we won't flood MMC with requests
-        delay(1);
-        timeOut--;
-    } while ((!mmc_io.isBitSet(STATUS_REG, MEAS_M_DONE)) && (timeOut > 0));
-
-    clearShadowBit(INT_CTRL_0_REG, TM_M, false); // Clear the bit - in shadow memory only
+    waitUntilMeasurementReady();
 
     uint32_t result = 0;
     uint8_t buffer[2] = {0};
@@ -967,27 +939,13 @@ uint32_t SFE_MMC5983MA::getMeasurementX()
 
 uint32_t SFE_MMC5983MA::getMeasurementY()
 {
-    // Set the TM_M bit to start the measurement.
-    // Do this using the shadow register. If we do it with setRegisterBit
-    // (read-modify-write) we end up setting the Auto_SR_en bit too as that
-    // always seems to read as 1...? I don't know why.
-    if (!setShadowBit(INT_CTRL_0_REG, TM_M))
-    {
-        clearShadowBit(INT_CTRL_0_REG, TM_M, false); // Clear the bit - in shadow memory only
-        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+    SFE_MMC5983MA_TIME_CALL(GET_MEASUREMENT_AXIS);
+
+    if (!startMeasurement())
         return 0;
-    }
 
     // Wait until measurement is completed or times out
-    uint16_t timeOut = getTimeout();
-    do
-    {
-        // Wait a little so we won't flood MMC with requests
-        delay(1);
-        timeOut--;
-    } while ((!mmc_io.isBitSet(STATUS_REG, MEAS_M_DONE)) && (timeOut > 0));
-
-    clearShadowBit(INT_CTRL_0_REG, TM_M, false); // Clear the bit - in shadow memory only
+    waitUntilMeasurementReady();
 
     uint32_t result = 0;
     uint8_t buffer[2] = {0};
@@ -1006,27 +964,13 @@ uint32_t SFE_MMC5983MA::getMeasurementY()
 
 uint32_t SFE_MMC5983MA::getMeasurementZ()
 {
-    // Set the TM_M bit to start the measurement.
-    // Do this using the shadow register. If we do it with setRegisterBit
-    // (read-modify-write) we end up setting the Auto_SR_en bit too as that
-    // always seems to read as 1...? I don't know why.
-    if (!setShadowBit(INT_CTRL_0_REG, TM_M))
-    {
-        clearShadowBit(INT_CTRL_0_REG, TM_M, false); // Clear the bit - in shadow memory only
-        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+    SFE_MMC5983MA_TIME_CALL(GET_MEASUREMENT_AXIS);
+
+    if (!startMeasurement())
         return 0;
-    }
 
     // Wait until measurement is completed or times out
-    uint16_t timeOut = getTimeout();
-    do
-    {
-        // Wait a little so we won't flood MMC with requests
-        delay(1);
-        timeOut--;
-    } while ((!mmc_io.isBitSet(STATUS_REG, MEAS_M_DONE)) && (timeOut > 0));
-
-    clearShadowBit(INT_CTRL_0_REG, TM_M, false); // Clear the bit - in shadow memory only
+    waitUntilMeasurementReady();
 
     uint32_t result = 0;
     uint8_t buffer[3] = {0};
@@ -1043,56 +987,246 @@ uint32_t SFE_MMC5983MA::getMeasurementZ()
 
 bool SFE_MMC5983MA::getMeasurementXYZ(uint32_t *x, uint32_t *y, uint32_t *z)
 {
+    SFE_MMC5983MA_TIME_CALL(GET_MEASUREMENT_XYZ);
+
+    if (!startMeasurement())
+        return false;
+
+    // Wait until measurement is completed or times out
+    bool done = waitUntilMeasurementReady();
+
+    // Read the fields even if a timeout occurred - old data vs no data
+    // Return false if a timeout or a read error occurred
+    return ((readFieldsXYZ(x, y, z)) && done);
+}
+
+bool SFE_MMC5983MA::startMeasurement()
+{
+    SFE_MMC5983MA_TIME_CALL(START_MEASUREMENT);
+
+    // TM_M and TM_T cannot be high at the same time: let any temperature conversion finish first
+    waitForConversion(&temperaturePending, temperatureStartMicros);
+
     // Set the TM_M bit to start the measurement.
     // Do this using the shadow register. If we do it with setRegisterBit
     // (read-modify-write) we end up setting the Auto_SR_en bit too as that
     // always seems to read as 1...? I don't know why.
-    bool success = setShadowBit(INT_CTRL_0_REG, TM_M);
+    if (!writeCommand<SFE_MMC5983MA_Fields::TmM>())
+    {
+        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+        return false;
+    }
 
-    if (!success)
+    measurementStartMicros = mmc_io.getMicros();
+    measurementPending = true;
+
+    // Every Nth measurement, readFrame() starts a temperature conversion once this one is done.
+    // TM_M and TM_T must not be set together, so it cannot go in the same write.
+    if ((temperatureInterval > 0) && (++conversionsSinceTemperature >= temperatureInterval))
+    {
+        conversionsSinceTemperature = 0;
+        temperatureDue = true;
+    }
+
+    return true;
+}
+
+bool SFE_MMC5983MA::startTemperatureMeasurement()
+{
+    SFE_MMC5983MA_TIME_CALL(START_TEMPERATURE_MEASUREMENT);
+
+    // TM_M and TM_T cannot be high at the same time: let any magnetic conversion finish first
+    waitForConversion(&measurementPending, measurementStartMicros);
+
+    // Set the TM_T bit to start the temperature conversion.
+    // Do this using the shadow register. If we do it with setRegisterBit
+    // (read-modify-write) we end up setting the Auto_SR_en bit too as that
+    // always seems to read as 1...? I don't know why.
+    if (!writeCommand<SFE_MMC5983MA_Fields::TmT>())
     {
-        clearShadowBit(INT_CTRL_0_REG, TM_M, false); // Clear the bit - in shadow memory only
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
         return false;
     }
 
-    // Wait until measurement is completed or times out
-    uint16_t timeOut = getTimeout();
-    do
+    temperatureStartMicros = mmc_io.getMicros();
+    temperaturePending = true;
+    return true;
+}
+
+bool SFE_MMC5983MA::isTemperatureReady()
+{
+    // The temperature conversion takes as long as a magnetic one,
+    // so don't spend a bus transaction checking before then
+    if ((mmc_io.getMicros() - temperatureStartMicros) < getMeasurementTime())
+        return false;
+
+    if (!mmc_io.isBitSet(STATUS_REG, MEAS_T_DONE))
+        return false;
+
+    temperaturePending = false;
+    return true;
+}
+
+bool SFE_MMC5983MA::readTemperature(int16_t *centiDegrees)
+{
+    SFE_MMC5983MA_TIME_CALL(READ_TEMPERATURE);
+
+    // T_OUT and STATUS are contiguous: read both in one go
+    uint8_t registerValues[2] = {0};
+
+    if (!mmc_io.readMultipleBytes(T_OUT_REG, registerValues, 2))
     {
-        // Wait a little so we won't flood MMC with requests
-        delay(1);
-        timeOut--;
-    } while ((!mmc_io.isBitSet(STATUS_REG, MEAS_M_DONE)) && (timeOut > 0));
+        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+        return false;
+    }
 
-    clearShadowBit(INT_CTRL_0_REG, TM_M, false); // Clear the bit - in shadow memory only
+    *centiDegrees = convertTemperature(registerValues[0]);
+    latestTemperature = *centiDegrees;
+    latestTemperatureIsNew = false;
 
-    // Read the fields even if a timeout occurred - old data vs no data
-    // Return false if a timeout or a read error occurred
-    return ((readFieldsXYZ(x, y, z)) && (timeOut > 0));
+    if (registerValues[1] & MEAS_T_DONE)
+        return clearMeasDoneInterrupt(MEAS_T_DONE);
+
+    return true;
 }
 
-bool SFE_MMC5983MA::readFieldsXYZ(uint32_t *x, uint32_t *y, uint32_t *z)
+int16_t SFE_MMC5983MA::convertTemperature(uint8_t rawTemperature)
+{
+    return (int16_t)(-7500 + (int16_t)(((int32_t)rawTemperature * 20000) / 255));
+}
+
+void SFE_MMC5983MA::setTemperatureInterval(uint16_t conversions)
+{
+    temperatureInterval = conversions;
+    conversionsSinceTemperature = 0;
+    temperatureDue = false;
+}
+
+bool SFE_MMC5983MA::getLatestTemperature(int16_t *centiDegrees)
+{
+    *centiDegrees = latestTemperature;
+
+    bool isNew = latestTemperatureIsNew;
+    latestTemperatureIsNew = false;
+    return isNew;
+}
+
+bool SFE_MMC5983MA::isMeasurementReady()
+{
+    SFE_MMC5983MA_TIME_CALL(IS_MEASUREMENT_READY);
+
+    // The measurement cannot be complete before the measurement time (defined by BW1/0)
+    // has elapsed, so don't spend a bus transaction checking
+    if ((mmc_io.getMicros() - measurementStartMicros) < getMeasurementTime())
+        return false;
+
+    if (!mmc_io.isBitSet(STATUS_REG, MEAS_M_DONE))
+        return false;
+
+    measurementPending = false;
+    return true;
+}
+
+bool SFE_MMC5983MA::waitUntilMeasurementReady()
+{
+    SFE_MMC5983MA_TIME_CALL(WAIT_UNTIL_MEASUREMENT_READY);
+
+    return (waitForMeasurement(MEAS_M_DONE, measurementStartMicros, getMeasurementTime(), getMeasurementTimeout()));
+}
+
+uint32_t SFE_MMC5983MA::getMeasurementStartTime()
+{
+    return measurementStartMicros;
+}
+
+void SFE_MMC5983MA::decodeFieldsXYZ(const uint8_t *registerValues, uint32_t *x, uint32_t *y, uint32_t *z)
+{
+    *x = registerValues[0]; // Xout[17:10]
+    *x = (*x << 8) | registerValues[1]; // Xout[9:2]
+    *x = (*x << 2) | (registerValues[6] >> 6); // Xout[1:0]
+    *y = registerValues[2]; // Yout[17:10]
+    *y = (*y << 8) | registerValues[3]; // Yout[9:2]
+    *y = (*y << 2) | ((registerValues[6] >> 4) & 0x03); // Yout[1:0]
+    *z = registerValues[4]; // Zout[17:10]
+    *z = (*z << 8) | registerValues[5]; // Zout[9:2]
+    *z = (*z << 2) | ((registerValues[6] >> 2) & 0x03); // Zout[1:0]
+}
+
+bool SFE_MMC5983MA::readFields(uint32_t *x, uint32_t *y, uint32_t *z)
 {
     uint8_t registerValues[7] = {0};
 
     bool success = (mmc_io.readMultipleBytes(X_OUT_0_REG, registerValues, 7));
 
     if (success)
-    {
-        *x = registerValues[0]; // Xout[17:10]
-        *x = (*x << 8) | registerValues[1]; // Xout[9:2]
-        *x = (*x << 2) | (registerValues[6] >> 6); // Xout[1:0]
-        *y = registerValues[2]; // Yout[17:10]
-        *y = (*y << 8) | registerValues[3]; // Yout[9:2]
-        *y = (*y << 2) | ((registerValues[6] >> 4) & 0x03); // Yout[1:0]
-        *z = registerValues[4]; // Zout[17:10]
-        *z = (*z << 8) | registerValues[5]; // Zout[9:2]
-        *z = (*z << 2) | ((registerValues[6] >> 2) & 0x03); // Zout[1:0]
-    }
+        decodeFieldsXYZ(registerValues, x, y, z);
     else
+        SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+
+    return success;
+}
+
+bool SFE_MMC5983MA::readFieldsXYZ(uint32_t *x, uint32_t *y, uint32_t *z)
+{
+    SFE_MMC5983MA_TIME_CALL(READ_FIELDS_XYZ);
+
+    bool success = readFields(x, y, z);
+
+    if (success)
+        publishFields(*x, *y, *z);
+
+    return success;
+}
+
+bool SFE_MMC5983MA::readFrame(SFE_MMC5983MA_Frame *frame, uint8_t clearMask)
+{
+    SFE_MMC5983MA_TIME_CALL(READ_FRAME);
+
+    // Registers 0x00 to 0x08 are contiguous: read the fields, temperature and status in one go
+    uint8_t registerValues[9] = {0};
+
+    bool success = (mmc_io.readMultipleBytes(X_OUT_0_REG, registerValues, 9));
+
+    if (!success)
     {
         SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+        return false;
+    }
+
+    decodeFieldsXYZ(registerValues, &frame->x, &frame->y, &frame->z);
+    frame->temperature = registerValues[T_OUT_REG];
+    frame->status = registerValues[STATUS_REG];
+
+    if (frame->status & MEAS_M_DONE)
+        measurementPending = false;
+
+    if (frame->status & MEAS_T_DONE)
+    {
+        temperaturePending = false;
+        latestTemperature = convertTemperature(frame->temperature);
+        latestTemperatureIsNew = true;
+    }
+
+    if (frameSinks != nullptr)
+        publishFrame(*frame);
+
+    // Only spend a bus transaction clearing the done bits if any of them are set
+    clearMask &= frame->status & (MEAS_T_DONE | MEAS_M_DONE);
+    if (clearMask)
+        success = clearMeasDoneInterrupt(clearMask);
+
+    // The magnetic conversion is over: start the temperature conversion due from setTemperatureInterval()
+    if (temperatureDue && (frame->status & MEAS_M_DONE))
+    {
+        if (!writeCommand<SFE_MMC5983MA_Fields::TmT>())
+        {
+            SAFE_CALLBACK(errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+            return false;
+        }
+
+        temperatureDue = false;
+        temperatureStartMicros = mmc_io.getMicros();
+        temperaturePending = true;
     }
 
     return success;
@@ -1100,10 +1234,93 @@ bool SFE_MMC5983MA::readFieldsXYZ(uint32_t *x, uint32_t *y, uint32_t *z)
 
 bool SFE_MMC5983MA::clearMeasDoneInterrupt(uint8_t measMask)
 {
+    SFE_MMC5983MA_TIME_CALL(CLEAR_MEAS_DONE_INTERRUPT);
+
     // Ensure only the Meas_T_Done and Meas_M_Done interrupts can be cleared
     measMask &= (MEAS_T_DONE | MEAS_M_DONE);
 
-    // Writing 1 into these bits will clear the corresponding interrupt
-    // Read-modify-write is OK here
-    return (mmc_io.setRegisterBit(STATUS_REG, measMask));
-}
\ No newline at end of file
+    // Writing 1 into these bits will clear the corresponding interrupt.
+    // The other status bits are read-only, so a single write is all we need.
+    // (A read-modify-write would also clear any other done bit which happened to be set.)
+    return (mmc_io.writeSingleByte(STATUS_REG, measMask));
+}
+
+void SFE_MMC5983MA::addFrameSink(SFE_MMC5983MA_FrameSink *sink)
+{
+    sink->nextSink = nullptr;
+
+    // The INT pin ISR may be walking the list: change it with interrupts disabled.
+    // There is no lock elsewhere: sinks must be added before another thread starts reading frames.
+#ifdef ARDUINO
+    noInterrupts();
+#endif
+
+    // Append, so sinks are called in the order they were added
+    SFE_MMC5983MA_FrameSink **link = &frameSinks;
+    while (*link != nullptr)
+        link = &(*link)->nextSink;
+    *link = sink;
+
+#ifdef ARDUINO
+    interrupts();
+#endif
+}
+
+void SFE_MMC5983MA::removeFrameSink(SFE_MMC5983MA_FrameSink *sink)
+{
+#ifdef ARDUINO
+    noInterrupts();
+#endif
+
+    for (SFE_MMC5983MA_FrameSink **link = &frameSinks; *link != nullptr; link = &(*link)->nextSink)
+    {
+        if (*link == sink)
+        {
+            *link = sink->nextSink;
+            sink->nextSink = nullptr;
+            break;
+        }
+    }
+
+#ifdef ARDUINO
+    interrupts();
+#endif
+}
+
+void SFE_MMC5983MA::publishFrame(const SFE_MMC5983MA_Frame &frame)
+{
+    uint32_t timestamp = mmc_io.getMicros();
+
+    for (SFE_MMC5983MA_FrameSink *sink = frameSinks; sink != nullptr; sink = sink->nextSink)
+        sink->onFrame(frame, timestamp);
+}
+
+void SFE_MMC5983MA::publishFields(uint32_t x, uint32_t y, uint32_t z)
+{
+    if (frameSinks == nullptr)
+        return;
+
+    SFE_MMC5983MA_Frame frame;
+    frame.x = x;
+    frame.y = y;
+    frame.z = z;
+    frame.status = MEAS_M_DONE;
+    publishFrame(frame);
+}
+
+void SFE_MMC5983MA::setStats(SFE_MMC5983MA_Stats *storage)
+{
+    stats = storage;
+    mmc_io.setBusStats((storage != nullptr) ? &storage->bus : nullptr);
+}
+
+void SFE_MMC5983MA::getStats(SFE_MMC5983MA_Stats *snapshot)
+{
+    *snapshot = (stats != nullptr) ? *stats : SFE_MMC5983MA_Stats();
+}
+
+void SFE_MMC5983MA::resetStats()
+{
+    if (stats != nullptr)
+        *stats = SFE_MMC5983MA_Stats();
+}
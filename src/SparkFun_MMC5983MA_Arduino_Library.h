@@ -15,15 +15,83 @@
 #ifndef _SPARKFUN_MMC5983MA_
 #define _SPARKFUN_MMC5983MA_
 
+#if defined(ARDUINO)
 #include <Arduino.h>
-#include <Wire.h>
-#include <SPI.h>
+#endif
 #include "SparkFun_MMC5983MA_IO.h"
 #include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
+#include "SparkFun_MMC5983MA_Profile.h"
+#include "SparkFun_MMC5983MA_Registers.h"
+
+// The result of a single burst read of registers 0x00 to 0x08.
+struct SFE_MMC5983MA_Frame
+{
+  uint32_t x = 0; // 18-bit X field
+  uint32_t y = 0; // 18-bit Y field
+  uint32_t z = 0; // 18-bit Z field
+  uint8_t temperature = 0; // Raw T_OUT. Only valid if MEAS_T_DONE is set in status
+  uint8_t status = 0; // STATUS_REG, before any done bits were cleared
+};
+
+// A consumer of the frames read by the driver. See SFE_MMC5983MA::addFrameSink().
+class SFE_MMC5983MA_FrameSink
+{
+private:
+  friend class SFE_MMC5983MA;
+
+  // The driver's list of sinks
+  SFE_MMC5983MA_FrameSink *nextSink = nullptr;
+
+public:
+  virtual ~SFE_MMC5983MA_FrameSink() {}
+
+  // Called with each frame, in the context which read it (e.g. the INT pin ISR), with the time
+  // (in microseconds, from the bus time base) at which it was read. Must not block or use the bus.
+  virtual void onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp) = 0;
+};
+
+// Records the time from construction to destruction against an API call, unless stats is nullptr
+class SFE_MMC5983MA_CallTimer
+{
+private:
+  SFE_MMC5983MA_CallStats *_stats;
+  SFE_MMC5983MA_IO &_io;
+  uint32_t _start = 0;
+
+public:
+  SFE_MMC5983MA_CallTimer(SFE_MMC5983MA_CallStats *stats, SFE_MMC5983MA_IO &io) : _stats(stats), _io(io)
+  {
+    if (_stats != nullptr)
+      _start = _io.getMicros();
+  }
+
+  ~SFE_MMC5983MA_CallTimer()
+  {
+    if (_stats != nullptr)
+      _stats->record(_io.getMicros() - _start);
+  }
+};
+
+// Times the enclosing API call, if statistics are enabled
+#ifdef SFE_MMC5983MA_ENABLE_STATS
+#define SFE_MMC5983MA_TIME_CALL(api) \
+  SFE_MMC5983MA_CallTimer callTimer((stats != nullptr) ? &stats->calls[(uint8_t)SFE_MMC5983MA_API::api] : nullptr, mmc_io)
+#else
+#define SFE_MMC5983MA_TIME_CALL(api)
+#endif
 
 class SFE_MMC5983MA
 {
 private:
+  // Raises errors through errorCallback
+  friend class SFE_MMC5983MA_RateMonitor;
+
+  // Drives the device one bus transaction at a time
+  friend class SFE_MMC5983MA_Async;
+
+  // Reads its SET and RESET measurements without passing them to the frame sinks
+  friend class SFE_MMC5983MA_Differential;
+
   // I2C communication object instance.
   SFE_MMC5983MA_IO mmc_io;
   // Error callback function pointer.
@@ -34,25 +102,114 @@ private:
   // are done in shadow memory locations. Default reset values are
   // set to the shadow memory locations upon initialization and after
   // any bit set in the shadow location the register is atomically written.
-  struct MemoryShadow
+  // Shadow memory for INT_CTRL_0_REG to INT_CTRL_3_REG, indexed by SFE_MMC5983MA_Register::index
+  uint8_t memoryShadow[SFE_MMC5983MA_SHADOW_REGISTERS] = {0, 0, 0, 0};
+
+  // Writes a value to a shadowed register
+  bool writeShadowRegister(uint8_t registerIndex, uint8_t value);
+
+  // Sets the field bit(s) on memory shadows and then registers (if doWrite is true)
+  template <typename Field>
+  bool setShadowField(bool doWrite = true)
   {
-    uint8_t internalControl0 = 0x0;
-    uint8_t internalControl1 = 0x0;
-    uint8_t internalControl2 = 0x0;
-    uint8_t internalControl3 = 0x0;
-  } memoryShadow;
+    memoryShadow[Field::RegisterType::index] |= Field::mask;
+    return doWrite ? writeShadowRegister(Field::RegisterType::index, memoryShadow[Field::RegisterType::index]) : true;
+  }
+
+  // Clears the field bit(s) on memory shadows and then registers (if doWrite is true)
+  template <typename Field>
+  bool clearShadowField(bool doWrite = true)
+  {
+    memoryShadow[Field::RegisterType::index] &= (uint8_t)~Field::mask;
+    return doWrite ? writeShadowRegister(Field::RegisterType::index, memoryShadow[Field::RegisterType::index]) : true;
+  }
+
+  // Replaces a (multi-bit) field on memory shadows and then registers (if doWrite is true). value starts at bit 0:
+  // it is shifted into place here.
+  template <typename Field>
+  bool writeShadowField(uint8_t value, bool doWrite = true)
+  {
+    uint8_t &shadow = memoryShadow[Field::RegisterType::index];
+    shadow = (uint8_t)((shadow & ~Field::mask) | ((value << Field::shift) & Field::mask));
+    return doWrite ? writeShadowRegister(Field::RegisterType::index, shadow) : true;
+  }
+
+  // Reads a (multi-bit) field from the memory shadow, shifted down to bit 0.
+  template <typename Field>
+  uint8_t readShadowField()
+  {
+    return (uint8_t)((memoryShadow[Field::RegisterType::index] & Field::mask) >> Field::shift);
+  }
+
+  // Checks if any bit of a field is set on a register memory shadow
+  template <typename Field>
+  bool isShadowFieldSet()
+  {
+    return (memoryShadow[Field::RegisterType::index] & Field::mask) != 0;
+  }
+
+  // Writes the register with a self-clearing command bit (TM_M, TM_T, SET, RESET, SW_RST) set.
+  // The bit is not stored in the memory shadow, so it is not repeated by later writes.
+  template <typename Field>
+  bool writeCommand()
+  {
+    return writeShadowRegister(Field::RegisterType::index, memoryShadow[Field::RegisterType::index] | Field::mask);
+  }
+
+  // Where the statistics are recorded, if anywhere. See setStats().
+  SFE_MMC5983MA_Stats *stats = nullptr;
 
-  // Sets register bit(s) on memory shadows and then registers (if doWrite is true)
-  bool setShadowBit(uint8_t registerAddress, const uint8_t bitMask, bool doWrite = true);
+  // Decodes the 18-bit X, Y and Z fields from registers 0x00 to 0x06
+  static void decodeFieldsXYZ(const uint8_t *registerValues, uint32_t *x, uint32_t *y, uint32_t *z);
 
-  // Clears register bit(s) on memory shadows and then registers (if doWrite is true)
-  bool clearShadowBit(uint8_t registerAddress, const uint8_t bitMask, bool doWrite = true);
+  // Reads the X, Y and Z fields like readFieldsXYZ(), without passing them to the frame sinks
+  bool readFields(uint32_t *x, uint32_t *y, uint32_t *z);
 
-  // Checks if a specific bit is set on a register memory shadow
-  bool isShadowBitSet(uint8_t registerAddress, const uint8_t bitMask);
+  // Measurement completion policy. See setMeasurementTimeout() and setPollInterval().
+  uint8_t timeoutMultiplier = 4;
+  uint16_t timeoutMarginMicros = 1000;
+  uint16_t pollIntervalMicros = 50;
 
-  // Return a timeout for getMeasurement based on BW1/0
-  uint16_t getTimeout();
+  // Time at which startMeasurement() triggered the current measurement.
+  uint32_t measurementStartMicros = 0;
+
+  // Temperature conversions. See startTemperatureMeasurement() and setTemperatureInterval().
+  uint32_t temperatureStartMicros = 0;
+  uint16_t temperatureInterval = 0;
+  uint16_t conversionsSinceTemperature = 0;
+  bool temperatureDue = false;
+  int16_t latestTemperature = 0;
+  bool latestTemperatureIsNew = false;
+
+  // Conversions which may still be running. TM_M and TM_T cannot be high at the same time,
+  // so neither conversion is started while the other is pending.
+  bool measurementPending = false;
+  bool temperaturePending = false;
+
+  // If the conversion started at startMicros is pending, sleeps for whatever is left of the measurement time
+  void waitForConversion(bool *pending, uint32_t startMicros);
+
+  // Consumers of the frames read. See addFrameSink().
+  SFE_MMC5983MA_FrameSink *frameSinks = nullptr;
+
+  // Passes a frame to every sink
+  void publishFrame(const SFE_MMC5983MA_Frame &frame);
+
+  // Passes fields to every sink, as a frame with no temperature and a status of MEAS_M_DONE
+  void publishFields(uint32_t x, uint32_t y, uint32_t z);
+
+  // Time for the device to reload its OTP memory after power on or a soft reset (datasheet), and the most we wait for it.
+  static const uint16_t OTP_READ_MICROS = 10000;
+  static const uint16_t OTP_READ_TIMEOUT_MICROS = 15000;
+
+  // Polls STATUS_REG until OTP_READ_DONE is set. Returns false after OTP_READ_TIMEOUT_MICROS.
+  // After a soft reset the bit may still be set from before it, so it is only trusted once it
+  // has been seen clear or OTP_READ_MICROS have passed.
+  bool waitForOTPReadDone(bool afterReset);
+
+  // Sleeps until expectedMicros have elapsed since startMicros, then polls STATUS_REG until any bit in doneMask is set.
+  // Returns false if timeoutMicros elapse (since startMicros) first.
+  bool waitForMeasurement(uint8_t doneMask, uint32_t startMicros, uint32_t expectedMicros, uint32_t timeoutMicros);
 
 public:
   // Default constructor.
@@ -67,22 +224,77 @@ public:
   // Convert errorCode to text
   const char *errorCodeString(SF_MMC5983MA_ERROR errorCode);
   
+#ifdef SFE_MMC5983MA_USE_I2C
   // Initializes MMC5983MA using I2C
   bool begin(TwoWire &wirePort = Wire);
 
+  // Use a repeated START instead of a STOP and START between the register address and the data
+  // on I2C reads. Saves a STOP/START and a bus arbitration on every read. Defaults to disabled.
+  void setI2CRepeatedStart(bool enable);
+#endif
+
+#ifdef SFE_MMC5983MA_USE_SPI
   // Initializes MMC5983MA using SPI
   bool begin(uint8_t csPin, SPIClass& spiPort = SPI);
   bool begin(uint8_t csPin, SPISettings userSettings, SPIClass& spiPort = SPI);
 
+  // Keeps one SPI transaction open across calls, until endSPITransaction(). Has no effect on I2C.
+  // Sensors on the same SPI bus (with the same settings) can share one transaction: the first
+  // calls beginSPITransaction(true) and the others beginSPITransaction(false).
+  void beginSPITransaction(bool ownTransaction = true);
+
+  // Ends the transaction started by beginSPITransaction().
+  void endSPITransaction();
+#endif
+
+#ifdef SFE_MMC5983MA_USE_BUS
+  // Initializes MMC5983MA using a custom bus backend (e.g. SFE_MMC5983MA_Simulator)
+  bool begin(SFE_MMC5983MA_Bus &bus);
+#endif
+
   // Polls if MMC5983MA is connected and if chip ID matches MMC5983MA chip id.
   bool isConnected();
 
   // Returns die temperature. Range is -75C to 125C.
   int getTemperature();
 
-  // Soft resets the device.
+  // Measures the die temperature and returns the raw T_OUT value: -75C + 200C * raw / 255 (about 0.8C per count).
+  bool getTemperatureRaw(uint8_t *rawTemperature);
+
+  // Starts a temperature measurement and returns immediately.
+  // Use isTemperatureReady() and readTemperature() to collect the result.
+  // If a magnetic measurement is still running, first waits for the rest of its measurement time.
+  bool startTemperatureMeasurement();
+
+  // Returns true when the temperature measurement is complete.
+  // The bus is not accessed until the expected measurement time has elapsed.
+  bool isTemperatureReady();
+
+  // Reads the temperature in hundredths of a degree C and clears MEAS_T_DONE. No floating point.
+  bool readTemperature(int16_t *centiDegrees);
+
+  // Converts a raw T_OUT value to hundredths of a degree C: -7500 + raw * 20000 / 255.
+  static int16_t convertTemperature(uint8_t rawTemperature);
+
+  // Starts a temperature conversion after every Nth startMeasurement(): readFrame() starts it, in its own write,
+  // once it sees that magnetic measurement done. The temperature arrives in a later readFrame() (see getLatestTemperature()).
+  // The two conversions cannot run at the same time, so the next startMeasurement() waits for the temperature
+  // conversion to finish: one measurement in N takes twice as long. 0 disables this (the default).
+  void setTemperatureInterval(uint16_t conversions);
+
+  // Returns the latest temperature (in hundredths of a degree C) seen by readFrame() or readTemperature().
+  // Returns true if it is new since the last call.
+  bool getLatestTemperature(int16_t *centiDegrees);
+
+  // Soft resets the device. Returns once the device has reloaded its OTP memory (about 10ms).
   bool softReset();
 
+  // Brings the device up with a configuration profile, as fast as possible: waits for
+  // OTP_READ_DONE with a short poll, then applies the profile in one write.
+  // Use reset = false straight after powering the device (cold start), or reset = true
+  // to soft reset a device which is already running (warm start). Call begin() once beforehand.
+  bool fastStart(const SFE_MMC5983MA_Profile &profile, bool reset = false);
+
   // Enables interrupt generation after measurement is completed.
   // Must be re-enabled after each measurement.
   bool enableInterrupt();
@@ -102,11 +314,11 @@ public:
   // Checks if SPI is enabled
   bool is3WireSPIEnabled();
 
-  // Performs SET operation
-  bool performSetOperation();
+  // Performs SET operation, then waits settleMicros. The operation itself takes 500ns.
+  bool performSetOperation(uint16_t settleMicros = 1000);
 
-  // Performs RESET operation
-  bool performResetOperation();
+  // Performs RESET operation, then waits settleMicros. The operation itself takes 500ns.
+  bool performResetOperation(uint16_t settleMicros = 1000);
 
   // Enables automatic SET/RESET
   bool enableAutomaticSetReset();
@@ -194,6 +406,26 @@ public:
   // Checks if extra current is applied from negative to positive side of coil.
   bool isExtraCurrentAppliedNegToPos();
 
+  // Writes all four internal control registers from a profile in a single bus transaction
+  // and updates the shadow memory. Fails with INVALID_PROFILE if profile.isValid() is false.
+  bool applyProfile(const SFE_MMC5983MA_Profile &profile);
+
+  // Returns the current configuration (from the shadow memory) as a profile.
+  SFE_MMC5983MA_Profile getProfile();
+
+  // Returns the expected measurement time in microseconds, based on BW1/0: 8000, 4000, 2000 or 500.
+  uint32_t getMeasurementTime();
+
+  // Returns the measurement timeout in microseconds, based on BW1/0 and the timeout policy.
+  uint32_t getMeasurementTimeout();
+
+  // Sets the measurement timeout policy: timeout = multiplier * measurement time + marginMicros.
+  // Defaults to 4 * measurement time + 1000us.
+  void setMeasurementTimeout(uint8_t multiplier, uint16_t marginMicros);
+
+  // Sets the back-off between STATUS_REG polls once the expected measurement time has elapsed. Defaults to 50us.
+  void setPollInterval(uint16_t intervalMicros);
+
   // Get X axis measurement
   uint32_t getMeasurementX();
 
@@ -206,12 +438,59 @@ public:
   // Get X, Y and Z field strengths in a single measurement
   bool getMeasurementXYZ(uint32_t *x, uint32_t *y, uint32_t *z);
 
+  // Starts a single X, Y and Z measurement and returns immediately.
+  // Use isMeasurementReady() and readFieldsXYZ() to collect the result.
+  // If a temperature conversion is still running, first waits for the rest of its measurement time.
+  bool startMeasurement();
+
+  // Returns true when the measurement started by startMeasurement() is complete.
+  // The bus is not accessed until the expected measurement time has elapsed.
+  bool isMeasurementReady();
+
+  // Waits until the measurement started by startMeasurement() is complete. Sleeps for whatever is left
+  // of the expected measurement time, then polls. Returns false if the measurement times out.
+  bool waitUntilMeasurementReady();
+
+  // Returns the time (in microseconds, from the bus time base) at which startMeasurement() triggered the measurement.
+  uint32_t getMeasurementStartTime();
+
   // Read and return the X, Y and Z field strengths
   bool readFieldsXYZ(uint32_t *x, uint32_t *y, uint32_t *z);
 
+  // Read the X, Y and Z fields, temperature and status in a single burst.
+  // Any Meas_T_Done and/or Meas_M_Done bits in clearMask which are set are then cleared with a single write.
+  // By default, clear both
+  bool readFrame(SFE_MMC5983MA_Frame *frame, uint8_t clearMask = MEAS_T_DONE | MEAS_M_DONE);
+
   // Clear the Meas_T_Done and/or Meas_M_Done interrupts
   // By default, clear both
   bool clearMeasDoneInterrupt(uint8_t measMask = MEAS_T_DONE | MEAS_M_DONE);
+
+  // Adds a sink which is given every frame read by readFrame() or readFieldsXYZ() (and so getMeasurementXYZ()),
+  // and every offset-free sample from SFE_MMC5983MA_Differential (but not its internal SET and RESET reads).
+  // Frames from readFieldsXYZ() and SFE_MMC5983MA_Differential have no temperature and their status is MEAS_M_DONE.
+  // Sinks are called in the order they were added. Do not add a sink twice.
+  // On Arduino the list is changed with interrupts disabled, so this is safe while an ISR reads frames
+  // on the same core (interrupts are enabled again afterwards).
+  // Everywhere else (e.g. Linux, or any SFE_MMC5983MA_BUS_ONLY build), and on Arduino with frames read on
+  // another core, the list has no lock: add every sink before acquisition starts (before the thread or task
+  // which reads frames is started), or from that thread itself.
+  void addFrameSink(SFE_MMC5983MA_FrameSink *sink);
+
+  // Removes a sink added by addFrameSink(), under the same rules: without interrupts to disable, only once
+  // acquisition has stopped, or from the thread which reads frames. The sink may be destroyed afterwards.
+  void removeFrameSink(SFE_MMC5983MA_FrameSink *sink);
+
+  // Records the bus transaction counters and the per API call latency histograms into storage, which
+  // must outlive the driver (nullptr stops recording). Nothing is recorded unless the library is built
+  // with SFE_MMC5983MA_ENABLE_STATS.
+  void setStats(SFE_MMC5983MA_Stats *storage);
+
+  // Copies the statistics into snapshot (all zero without setStats())
+  void getStats(SFE_MMC5983MA_Stats *snapshot);
+
+  // Clears all statistics
+  void resetStats();
 };
 
 #endif
\ No newline at end of file
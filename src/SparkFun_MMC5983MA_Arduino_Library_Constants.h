@@ -15,7 +15,12 @@
 #ifndef _SPARKFUN_MMC5983MA_CONSTANTS_
 #define _SPARKFUN_MMC5983MA_CONSTANTS_
 
+#if defined(ARDUINO)
 #include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
 
 // Macro for invoking the callback if the function pointer is valid
 #define SAFE_CALLBACK(cb, code) \
@@ -88,7 +93,11 @@ enum class SF_MMC5983MA_ERROR
   BUS_ERROR,
   INVALID_FILTER_BANDWIDTH,
   INVALID_CONTINUOUS_FREQUENCY,
-  INVALID_PERIODIC_SAMPLES
+  INVALID_PERIODIC_SAMPLES,
+  BUS_INITIALIZATION_ERROR,
+  INVALID_PROFILE,
+  DATA_RATE_TOO_LOW,
+  DATA_STALLED
 };
 
 #endif
\ No newline at end of file
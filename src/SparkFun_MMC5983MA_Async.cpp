@@ -0,0 +1,261 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements the non-blocking front end.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Async.h"
+
+bool SFE_MMC5983MA_Async::start(State first)
+{
+    if (state != State::IDLE)
+        return false;
+
+    state = first;
+    result = SFE_MMC5983MA_AsyncStatus::PENDING;
+    waitMicros = 0;
+    timeoutMicros = 0;
+    return true;
+}
+
+SFE_MMC5983MA_AsyncStatus SFE_MMC5983MA_Async::finish(SFE_MMC5983MA_AsyncStatus status)
+{
+    state = State::IDLE;
+    result = status;
+    return status;
+}
+
+SFE_MMC5983MA_AsyncStatus SFE_MMC5983MA_Async::busError()
+{
+    SAFE_CALLBACK(sensor.errorCallback, SF_MMC5983MA_ERROR::BUS_ERROR);
+    return finish(SFE_MMC5983MA_AsyncStatus::ERROR);
+}
+
+void SFE_MMC5983MA_Async::waitFor(State next, uint32_t now, uint32_t delay, uint32_t timeout)
+{
+    state = next;
+    startMicros = now;
+    waitMicros = delay;
+    timeoutMicros = timeout;
+}
+
+bool SFE_MMC5983MA_Async::startSoftReset()
+{
+    return start(State::SOFT_RESET_WRITE);
+}
+
+bool SFE_MMC5983MA_Async::startConfigure(const SFE_MMC5983MA_Profile &configuration)
+{
+    if (!start(State::CONFIGURE_WRITE))
+        return false;
+
+    profile = configuration;
+    return true;
+}
+
+bool SFE_MMC5983MA_Async::startSetOperation(uint16_t settle)
+{
+    if (!start(State::SET_WRITE))
+        return false;
+
+    settleMicros = settle;
+    return true;
+}
+
+bool SFE_MMC5983MA_Async::startResetOperation(uint16_t settle)
+{
+    if (!start(State::RESET_WRITE))
+        return false;
+
+    settleMicros = settle;
+    return true;
+}
+
+bool SFE_MMC5983MA_Async::startMeasurement()
+{
+    return start(State::MEASURE_WRITE);
+}
+
+bool SFE_MMC5983MA_Async::startTemperatureMeasurement()
+{
+    return start(State::TEMPERATURE_WRITE);
+}
+
+SFE_MMC5983MA_AsyncStatus SFE_MMC5983MA_Async::poll(uint32_t now)
+{
+    if (state == State::IDLE)
+        return result;
+
+    SFE_MMC5983MA_AsyncStatus status = step(now);
+
+#ifdef SFE_MMC5983MA_COROUTINES
+    // Resume last: the coroutine may start the next operation
+    if ((status != SFE_MMC5983MA_AsyncStatus::PENDING) && waiter)
+    {
+        std::coroutine_handle<> handle = waiter;
+        waiter = nullptr;
+        handle.resume();
+    }
+#endif
+
+    return status;
+}
+
+SFE_MMC5983MA_AsyncStatus SFE_MMC5983MA_Async::step(uint32_t now)
+{
+    // Nothing to do until the current step is due
+    uint32_t elapsed = now - startMicros;
+    if (elapsed < waitMicros)
+        return SFE_MMC5983MA_AsyncStatus::PENDING;
+
+    switch (state)
+    {
+    case State::SOFT_RESET_WRITE:
+        if (!sensor.writeCommand<SFE_MMC5983MA_Fields::SwRst>())
+            return busError();
+
+        // The reset clears all the control registers
+        for (uint8_t i = 0; i < SFE_MMC5983MA_SHADOW_REGISTERS; i++)
+            sensor.memoryShadow[i] = 0;
+
+        // Back off first, so the status is not read before the reset has started
+        otpSeenClear = false;
+        waitFor(State::SOFT_RESET_POLL, now, sensor.pollIntervalMicros, SFE_MMC5983MA::OTP_READ_TIMEOUT_MICROS);
+        return SFE_MMC5983MA_AsyncStatus::PENDING;
+
+    case State::SOFT_RESET_POLL:
+    {
+        // The device may not answer while it is reading its OTP memory,
+        // so a failed read only means it is not ready yet
+        uint8_t status = 0;
+        if (sensor.mmc_io.readSingleByte(STATUS_REG, &status))
+        {
+            // OTP_READ_DONE may still be set from before the reset (see SFE_MMC5983MA::waitForOTPReadDone())
+            if ((status & OTP_READ_DONE) == 0)
+                otpSeenClear = true;
+            else if (otpSeenClear || (elapsed >= SFE_MMC5983MA::OTP_READ_MICROS))
+                return finish(SFE_MMC5983MA_AsyncStatus::DONE);
+        }
+        break;
+    }
+
+    case State::CONFIGURE_WRITE:
+        // applyProfile() raises its own errors
+        return finish(sensor.applyProfile(profile) ? SFE_MMC5983MA_AsyncStatus::DONE : SFE_MMC5983MA_AsyncStatus::ERROR);
+
+    case State::SET_WRITE:
+    case State::RESET_WRITE:
+    {
+        bool success = (state == State::SET_WRITE) ? sensor.writeCommand<SFE_MMC5983MA_Fields::Set>()
+                                                   : sensor.writeCommand<SFE_MMC5983MA_Fields::Reset>();
+        if (!success)
+            return busError();
+
+        if (settleMicros == 0)
+            return finish(SFE_MMC5983MA_AsyncStatus::DONE);
+
+        waitFor(State::SETTLE, now, settleMicros, settleMicros);
+        return SFE_MMC5983MA_AsyncStatus::PENDING;
+    }
+
+    case State::SETTLE:
+        return finish(SFE_MMC5983MA_AsyncStatus::DONE);
+
+    case State::MEASURE_WRITE:
+        // startMeasurement() raises its own errors
+        if (!sensor.startMeasurement())
+            return finish(SFE_MMC5983MA_AsyncStatus::ERROR);
+
+        // There is no point polling the status register before the conversion can have finished
+        waitFor(State::MEASURE_POLL, now, sensor.getMeasurementTime(), sensor.getMeasurementTimeout());
+        return SFE_MMC5983MA_AsyncStatus::PENDING;
+
+    case State::TEMPERATURE_WRITE:
+        if (!sensor.startTemperatureMeasurement())
+            return finish(SFE_MMC5983MA_AsyncStatus::ERROR);
+
+        // The temperature conversion takes as long as a magnetic one
+        waitFor(State::TEMPERATURE_POLL, now, sensor.getMeasurementTime(), sensor.getMeasurementTimeout());
+        return SFE_MMC5983MA_AsyncStatus::PENDING;
+
+    case State::MEASURE_POLL:
+    case State::TEMPERATURE_POLL:
+    {
+        uint8_t doneMask = (state == State::MEASURE_POLL) ? MEAS_M_DONE : MEAS_T_DONE;
+
+        uint8_t status = 0;
+        if (!sensor.mmc_io.readSingleByte(STATUS_REG, &status))
+            return busError();
+
+        if (status & doneMask)
+        {
+            // Read the result on the next poll
+            waitFor((state == State::MEASURE_POLL) ? State::MEASURE_READ : State::TEMPERATURE_READ, now, 0, 0);
+            return SFE_MMC5983MA_AsyncStatus::PENDING;
+        }
+        break;
+    }
+
+    case State::MEASURE_READ:
+        // readFieldsXYZ() raises its own errors, and passes the frame to any frame sinks
+        return finish(sensor.readFieldsXYZ(&fieldX, &fieldY, &fieldZ) ? SFE_MMC5983MA_AsyncStatus::DONE : SFE_MMC5983MA_AsyncStatus::ERROR);
+
+    case State::TEMPERATURE_READ:
+    {
+        uint8_t rawTemperature = 0;
+        if (!sensor.mmc_io.readSingleByte(T_OUT_REG, &rawTemperature))
+            return busError();
+
+        temperature = SFE_MMC5983MA::convertTemperature(rawTemperature);
+        sensor.latestTemperature = temperature;
+        sensor.latestTemperatureIsNew = false;
+
+        waitFor(State::TEMPERATURE_CLEAR, now, 0, 0);
+        return SFE_MMC5983MA_AsyncStatus::PENDING;
+    }
+
+    case State::TEMPERATURE_CLEAR:
+        if (!sensor.clearMeasDoneInterrupt(MEAS_T_DONE))
+            return busError();
+        return finish(SFE_MMC5983MA_AsyncStatus::DONE);
+
+    default:
+        return finish(SFE_MMC5983MA_AsyncStatus::ERROR);
+    }
+
+    // A poll step which is not done yet: poll again after the back-off, unless it has timed out
+    if (elapsed >= timeoutMicros)
+    {
+#ifdef SFE_MMC5983MA_ENABLE_STATS
+        sensor.mmc_io.recordTimeout();
+#endif
+        return finish(SFE_MMC5983MA_AsyncStatus::ERROR);
+    }
+
+    waitMicros = elapsed + sensor.pollIntervalMicros;
+    return SFE_MMC5983MA_AsyncStatus::PENDING;
+}
+
+bool SFE_MMC5983MA_Async::isBusy()
+{
+    return state != State::IDLE;
+}
+
+void SFE_MMC5983MA_Async::getFields(uint32_t *x, uint32_t *y, uint32_t *z)
+{
+    *x = fieldX;
+    *y = fieldY;
+    *z = fieldZ;
+}
+
+int16_t SFE_MMC5983MA_Async::getTemperature()
+{
+    return temperature;
+}
@@ -0,0 +1,173 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a non-blocking front end to the driver, for single-threaded event loops.
+  The blocking calls (softReset(), performSetOperation(), getMeasurementXYZ(), getTemperature()...)
+  wait for the device with delay(). Here each operation is a state machine instead: start it, then
+  call poll() with the current time until it returns DONE or ERROR. A poll() call makes at most one
+  bus transaction, and none at all until the device can be ready, so it never waits.
+
+  Only one operation runs at a time. Bus failures raise BUS_ERROR through the driver's error
+  callback. Timeouts (the device did not finish in time) just end the operation with ERROR.
+
+  With C++20 coroutines, co_await wait() suspends a coroutine until the operation finishes: poll()
+  resumes it. SFE_MMC5983MA_Task is a minimal coroutine type for this.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_ASYNC_
+#define _SPARKFUN_MMC5983MA_ASYNC_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+#include <coroutine>
+#define SFE_MMC5983MA_COROUTINES
+#endif
+
+enum class SFE_MMC5983MA_AsyncStatus : uint8_t
+{
+  PENDING,
+  DONE,
+  ERROR
+};
+
+class SFE_MMC5983MA_Async
+{
+private:
+  SFE_MMC5983MA &sensor;
+
+  enum class State : uint8_t
+  {
+    IDLE,
+    SOFT_RESET_WRITE,
+    SOFT_RESET_POLL,
+    CONFIGURE_WRITE,
+    SET_WRITE,
+    RESET_WRITE,
+    SETTLE,
+    MEASURE_WRITE,
+    MEASURE_POLL,
+    MEASURE_READ,
+    TEMPERATURE_WRITE,
+    TEMPERATURE_POLL,
+    TEMPERATURE_READ,
+    TEMPERATURE_CLEAR
+  };
+
+  State state = State::IDLE;
+  SFE_MMC5983MA_AsyncStatus result = SFE_MMC5983MA_AsyncStatus::DONE;
+
+  // Timing of the current step: the next bus access is due at startMicros + waitMicros,
+  // and the step fails at startMicros + timeoutMicros
+  uint32_t startMicros = 0;
+  uint32_t waitMicros = 0;
+  uint32_t timeoutMicros = 0;
+  uint16_t settleMicros = 0;
+
+  // Set once STATUS_REG has shown OTP_READ_DONE clear after a soft reset
+  bool otpSeenClear = false;
+
+  SFE_MMC5983MA_Profile profile;
+
+  // Results
+  uint32_t fieldX = 0;
+  uint32_t fieldY = 0;
+  uint32_t fieldZ = 0;
+  int16_t temperature = 0;
+
+#ifdef SFE_MMC5983MA_COROUTINES
+  std::coroutine_handle<> waiter;
+#endif
+
+  // Starts an operation at its first step. Returns false if one is already running.
+  bool start(State first);
+
+  // Ends the operation
+  SFE_MMC5983MA_AsyncStatus finish(SFE_MMC5983MA_AsyncStatus status);
+
+  // Ends the operation after a failed bus transaction
+  SFE_MMC5983MA_AsyncStatus busError();
+
+  // Moves to a step which waits: the next bus access is due after delay, and the step fails after timeout
+  void waitFor(State next, uint32_t now, uint32_t delay, uint32_t timeout);
+
+  // Advances the state machine by at most one bus transaction
+  SFE_MMC5983MA_AsyncStatus step(uint32_t now);
+
+public:
+  SFE_MMC5983MA_Async(SFE_MMC5983MA &mag) : sensor(mag) {}
+
+  // Each start call only records the operation: the bus is not accessed until poll().
+  // They return false, and do nothing, if an operation is still running.
+
+  // Soft resets the device and waits for it to reload its OTP memory (about 10ms)
+  bool startSoftReset();
+
+  // Writes all four control registers from a profile (see SFE_MMC5983MA::applyProfile())
+  bool startConfigure(const SFE_MMC5983MA_Profile &configuration);
+
+  // Performs a SET or RESET operation, then waits settle microseconds
+  bool startSetOperation(uint16_t settle = 1000);
+  bool startResetOperation(uint16_t settle = 1000);
+
+  // Measures X, Y and Z once. Collect the result with getFields().
+  bool startMeasurement();
+
+  // Measures the die temperature once. Collect the result with getTemperature().
+  bool startTemperatureMeasurement();
+
+  // Advances the current operation, with the time in microseconds from the bus time base (e.g. micros()).
+  // Returns PENDING while it runs, then DONE or ERROR; with no operation running, returns the last result.
+  SFE_MMC5983MA_AsyncStatus poll(uint32_t now);
+
+  // Returns true while an operation is running
+  bool isBusy();
+
+  // Returns the fields from the last measurement
+  void getFields(uint32_t *x, uint32_t *y, uint32_t *z);
+
+  // Returns the temperature from the last temperature measurement, in hundredths of a degree C
+  int16_t getTemperature();
+
+#ifdef SFE_MMC5983MA_COROUTINES
+  // Awaits the current operation. co_await returns true if it finished with DONE.
+  class Awaiter
+  {
+  private:
+    SFE_MMC5983MA_Async &async;
+
+  public:
+    Awaiter(SFE_MMC5983MA_Async &operation) : async(operation) {}
+    bool await_ready() const noexcept { return !async.isBusy(); }
+    void await_suspend(std::coroutine_handle<> handle) noexcept { async.waiter = handle; }
+    bool await_resume() const noexcept { return async.result == SFE_MMC5983MA_AsyncStatus::DONE; }
+  };
+
+  // Suspends the awaiting coroutine until poll() finishes the current operation
+  Awaiter wait() { return Awaiter(*this); }
+#endif
+};
+
+#ifdef SFE_MMC5983MA_COROUTINES
+// A fire-and-forget coroutine: it runs when called, until its first co_await, and frees itself when it returns
+struct SFE_MMC5983MA_Task
+{
+  struct promise_type
+  {
+    SFE_MMC5983MA_Task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept {}
+  };
+};
+#endif
+
+#endif
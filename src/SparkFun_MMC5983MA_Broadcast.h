@@ -0,0 +1,199 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a single-producer, multiple-consumer broadcast ring. The producer writes
+  each frame (and its timestamp) once; every subscriber has its own read cursor and reads the
+  frames in place, as pointer/length views over contiguous runs of the ring.
+
+  The producer never waits for subscribers and does not look at them, so its cost does not depend
+  on how many there are. A subscriber which falls Capacity frames behind has frames overwritten:
+  peek() then skips it forward (counting the frames dropped), and release() reports a batch which
+  was overwritten while it was being processed, so slow consumers are detected rather than
+  stalling the producer.
+
+  Attach it to the driver with addFrameSink(), or call publish() directly. Only one context may publish.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_BROADCAST_
+#define _SPARKFUN_MMC5983MA_BROADCAST_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+#include "SparkFun_MMC5983MA_RingBuffer.h"
+
+// The cursors are free-running, so a subscriber must peek() at least once every (index range - Capacity)
+// frames to notice it has fallen behind. On 8-bit AVR only single byte accesses are atomic, which keeps
+// the range to 256; elsewhere it is 2^32.
+#if defined(__AVR__)
+typedef uint8_t sfe_mmc5983ma_broadcast_index_t;
+#else
+typedef uint32_t sfe_mmc5983ma_broadcast_index_t;
+#endif
+
+// Capacity must be a power of two, and no more than half the index range (as for SFE_MMC5983MA_RingBuffer).
+template <sfe_mmc5983ma_broadcast_index_t Capacity, uint8_t Subscribers = 4>
+class SFE_MMC5983MA_Broadcast : public SFE_MMC5983MA_FrameSink
+{
+  static_assert((Capacity >= 4) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of two");
+  static_assert(Capacity <= (sfe_mmc5983ma_broadcast_index_t)(~(sfe_mmc5983ma_broadcast_index_t)0) / 2 + 1, "Capacity is too large");
+  static_assert(Subscribers >= 1, "There must be at least one subscriber");
+
+private:
+  SFE_MMC5983MA_Frame frames[Capacity];
+  uint32_t timestamps[Capacity];
+
+  // Free-running count of frames published. Only written by the producer.
+  volatile sfe_mmc5983ma_broadcast_index_t head = 0;
+  volatile uint32_t published = 0;
+
+  // Each subscriber's state is only written by that subscriber
+  struct Subscriber
+  {
+    volatile bool active;
+    volatile sfe_mmc5983ma_broadcast_index_t cursor; // Next frame to read
+    volatile uint32_t droppedFrames;
+    volatile uint32_t overwrittenBatches;
+  };
+  Subscriber subscribers[Subscribers];
+
+public:
+  SFE_MMC5983MA_Broadcast()
+  {
+    for (uint8_t i = 0; i < Subscribers; i++)
+      subscribers[i].active = false;
+  }
+
+  // Producer: stores a frame read at timestamp. Never waits.
+  void publish(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp)
+  {
+    sfe_mmc5983ma_broadcast_index_t currentHead = head;
+    __atomic_thread_fence(__ATOMIC_RELEASE); // Don't overwrite the oldest frame before the previous head is published
+
+    frames[currentHead & (Capacity - 1)] = frame;
+    timestamps[currentHead & (Capacity - 1)] = timestamp;
+    __atomic_thread_fence(__ATOMIC_RELEASE); // Publish the frame before the new head
+
+    head = currentHead + 1;
+    published = published + 1;
+  }
+
+  // Driver hook: see SFE_MMC5983MA::addFrameSink()
+  void onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp) override
+  {
+    publish(frame, timestamp);
+  }
+
+  // Adds a subscriber, which sees the frames published from now on.
+  // Returns its number, for the calls below, or -1 if all Subscribers are in use.
+  int8_t subscribe()
+  {
+    for (uint8_t i = 0; i < Subscribers; i++)
+    {
+      Subscriber &subscriber = subscribers[i];
+      if (subscriber.active)
+        continue;
+
+      subscriber.cursor = head;
+      subscriber.droppedFrames = 0;
+      subscriber.overwrittenBatches = 0;
+      subscriber.active = true;
+      return (int8_t)i;
+    }
+    return -1;
+  }
+
+  void unsubscribe(uint8_t subscriber)
+  {
+    subscribers[subscriber].active = false;
+  }
+
+  // Subscriber: returns the number of frames waiting. Can be more than Capacity if the subscriber has fallen behind.
+  sfe_mmc5983ma_broadcast_index_t available(uint8_t subscriber) const
+  {
+    return head - subscribers[subscriber].cursor;
+  }
+
+  // Subscriber: points frames (and timestamps, if given) at the next contiguous run of unread frames,
+  // and returns its length (0 if there are none). The frames stay valid until the producer has published
+  // about Capacity more: call release() when done with them to find out if they were overwritten.
+  // If the subscriber has fallen so far behind that its next frame has been overwritten, the frames it
+  // missed are counted as dropped and it skips forward, to half the ring behind the producer.
+  sfe_mmc5983ma_broadcast_index_t peek(uint8_t subscriber, const SFE_MMC5983MA_Frame **framesView, const uint32_t **timestampsView = nullptr)
+  {
+    Subscriber &state = subscribers[subscriber];
+    sfe_mmc5983ma_broadcast_index_t currentHead = head;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // Don't read a frame before the producer has published it
+
+    sfe_mmc5983ma_broadcast_index_t cursor = state.cursor;
+    sfe_mmc5983ma_broadcast_index_t waiting = currentHead - cursor;
+
+    // The slot of frame head - Capacity is the one the producer writes next
+    if (waiting >= Capacity)
+    {
+      sfe_mmc5983ma_broadcast_index_t resume = currentHead - (Capacity / 2);
+      state.droppedFrames = state.droppedFrames + (sfe_mmc5983ma_broadcast_index_t)(resume - cursor);
+      cursor = resume;
+      state.cursor = cursor;
+      waiting = Capacity / 2;
+    }
+
+    // Up to the end of the ring
+    sfe_mmc5983ma_broadcast_index_t start = cursor & (Capacity - 1);
+    sfe_mmc5983ma_broadcast_index_t length = waiting;
+    if (length > Capacity - start)
+      length = Capacity - start;
+
+    *framesView = &frames[start];
+    if (timestampsView != nullptr)
+      *timestampsView = &timestamps[start];
+    return length;
+  }
+
+  // Subscriber: marks count frames from the last peek() as read.
+  // Returns false (and counts an overwritten batch) if the producer overwrote any of them before this call,
+  // in which case the results computed from them should be discarded.
+  bool release(uint8_t subscriber, sfe_mmc5983ma_broadcast_index_t count)
+  {
+    Subscriber &state = subscribers[subscriber];
+    sfe_mmc5983ma_broadcast_index_t cursor = state.cursor;
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // Finish reading the frames before checking the head
+    sfe_mmc5983ma_broadcast_index_t currentHead = head;
+
+    state.cursor = cursor + count;
+
+    // While frame head is being written, frame head - Capacity is overwritten
+    if ((sfe_mmc5983ma_broadcast_index_t)(currentHead - cursor) >= Capacity)
+    {
+      state.overwrittenBatches = state.overwrittenBatches + 1;
+      return false;
+    }
+    return true;
+  }
+
+  // Returns the number of frames the subscriber missed because it fell Capacity frames behind.
+  uint32_t getDroppedFrames(uint8_t subscriber) const
+  {
+    return subscribers[subscriber].droppedFrames;
+  }
+
+  // Returns the number of batches which were overwritten while the subscriber was processing them.
+  uint32_t getOverwrittenBatches(uint8_t subscriber) const
+  {
+    return subscribers[subscriber].overwrittenBatches;
+  }
+
+  // Returns the number of frames published.
+  uint32_t getPublished() const
+  {
+    return published;
+  }
+};
+
+#endif
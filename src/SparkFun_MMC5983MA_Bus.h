@@ -0,0 +1,60 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares the abstract bus backend used by the MMC5983MA IO layer for buses other than
+  Arduino Wire and SPI: host-side simulators, Linux userspace drivers, etc.
+  It has no Arduino dependencies.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_BUS_
+#define _SPARKFUN_MMC5983MA_BUS_
+
+#include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
+
+class SFE_MMC5983MA_Bus
+{
+public:
+  virtual ~SFE_MMC5983MA_Bus() {}
+
+  // Reads packetLength bytes, starting at registerAddress, into buffer.
+  virtual bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) = 0;
+
+  // Writes packetLength bytes from buffer, starting at registerAddress.
+  virtual bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) = 0;
+
+  // Returns a free-running microsecond count. All of the driver's timing goes through
+  // the bus, so a simulated bus can run the driver against simulated time.
+  virtual uint32_t getMicros() = 0;
+
+  // Waits for the given number of microseconds.
+  virtual void waitMicros(uint32_t duration) = 0;
+
+  // Read a single uint8_t from a register.
+  virtual bool readSingleByte(const uint8_t registerAddress, uint8_t *buffer)
+  {
+    return readMultipleBytes(registerAddress, buffer, 1);
+  }
+
+  // Writes a single uint8_t into a register.
+  virtual bool writeSingleByte(const uint8_t registerAddress, const uint8_t value)
+  {
+    uint8_t buffer = value;
+    return writeMultipleBytes(registerAddress, &buffer, 1);
+  }
+
+  // Returns true if we get the correct product ID from the device.
+  virtual bool isConnected()
+  {
+    uint8_t id = 0;
+    return (readSingleByte(PROD_ID_REG, &id) && (id == PROD_ID));
+  }
+};
+
+#endif
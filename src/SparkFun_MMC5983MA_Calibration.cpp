@@ -0,0 +1,67 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements the fixed-point calibration stage.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Calibration.h"
+
+// Mid-scale of the 18-bit fields
+static const int32_t MID_SCALE = 131072;
+
+// 1 count = 15625 / 256 uG
+static const int32_t MICROGAUSS_PER_COUNT_NUMERATOR = 15625;
+static const uint8_t MICROGAUSS_PER_COUNT_SHIFT = 8;
+
+SFE_MMC5983MA_Calibration::SFE_MMC5983MA_Calibration()
+{
+    setOffset(0, 0, 0);
+
+    const int32_t identity[3][3] = {{65536, 0, 0}, {0, 65536, 0}, {0, 0, 65536}};
+    setMatrix(identity);
+}
+
+void SFE_MMC5983MA_Calibration::setOffset(int32_t x, int32_t y, int32_t z)
+{
+    zero[0] = MID_SCALE + x;
+    zero[1] = MID_SCALE + y;
+    zero[2] = MID_SCALE + z;
+}
+
+void SFE_MMC5983MA_Calibration::setMatrix(const int32_t q16Matrix[3][3])
+{
+    for (uint8_t row = 0; row < 3; row++)
+    {
+        for (uint8_t column = 0; column < 3; column++)
+        {
+            matrix[row][column] = q16Matrix[row][column];
+
+            // Fold in the count to uG scale, rounding to the nearest Q16 step
+            int64_t scaled = (int64_t)q16Matrix[row][column] * MICROGAUSS_PER_COUNT_NUMERATOR;
+            scaledMatrix[row][column] = (int32_t)((scaled + (1 << (MICROGAUSS_PER_COUNT_SHIFT - 1))) >> MICROGAUSS_PER_COUNT_SHIFT);
+        }
+    }
+}
+
+void SFE_MMC5983MA_Calibration::getOffset(int32_t *x, int32_t *y, int32_t *z)
+{
+    *x = zero[0] - MID_SCALE;
+    *y = zero[1] - MID_SCALE;
+    *z = zero[2] - MID_SCALE;
+}
+
+void SFE_MMC5983MA_Calibration::getMatrix(int32_t q16Matrix[3][3])
+{
+    for (uint8_t row = 0; row < 3; row++)
+    {
+        for (uint8_t column = 0; column < 3; column++)
+            q16Matrix[row][column] = matrix[row][column];
+    }
+}
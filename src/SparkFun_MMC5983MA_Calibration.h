@@ -0,0 +1,77 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a fixed-point calibration stage which turns raw 18-bit fields into
+  calibrated signed field values in micro-Gauss, with no floating point:
+
+    field = M * (raw - 131072 - offset)
+
+  offset is the hard-iron offset in counts and M is the 3x3 soft-iron matrix (Q16, 1.0 = 65536).
+  1 count = 8 Gauss / 131072 = 15625/256 uG exactly, so the scale is folded into M when it is set.
+  The products are summed in 64 bits. The result is within 0.5uG + 3 * 2^-17 * |raw - 131072 - offset| uG
+  of the exact value for the Q16 matrix, i.e. under 7uG (0.11 counts) over the full range.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_CALIBRATION_
+#define _SPARKFUN_MMC5983MA_CALIBRATION_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+
+class SFE_MMC5983MA_Calibration
+{
+private:
+  // Mid-scale plus the hard-iron offset, in counts
+  int32_t zero[3];
+
+  // Soft-iron matrix times 15625/256, in uG per count (Q16)
+  int32_t scaledMatrix[3][3];
+
+  // The soft-iron matrix as set, in Q16
+  int32_t matrix[3][3];
+
+public:
+  // Unit gain on every axis (1 count = 15625/256 uG), no offset.
+  SFE_MMC5983MA_Calibration();
+
+  // Sets the hard-iron offset, in counts relative to mid-scale (as returned by SFE_MMC5983MA_Differential::getOffset()).
+  void setOffset(int32_t x, int32_t y, int32_t z);
+
+  // Sets the soft-iron matrix, in Q16 (1.0 = 65536). Rows give the output axes.
+  void setMatrix(const int32_t q16Matrix[3][3]);
+
+  void getOffset(int32_t *x, int32_t *y, int32_t *z);
+  void getMatrix(int32_t q16Matrix[3][3]);
+
+  // Converts raw 18-bit fields (e.g. from readFieldsXYZ()) to calibrated fields in uG.
+  // Inline: this is the per-sample hot path.
+  void apply(uint32_t rawX, uint32_t rawY, uint32_t rawZ, int32_t *x, int32_t *y, int32_t *z) const
+  {
+    int32_t counts[3] = {(int32_t)rawX - zero[0], (int32_t)rawY - zero[1], (int32_t)rawZ - zero[2]};
+    int32_t *const results[3] = {x, y, z};
+
+    for (uint8_t row = 0; row < 3; row++)
+    {
+      int64_t sum = (int64_t)scaledMatrix[row][0] * counts[0] +
+                    (int64_t)scaledMatrix[row][1] * counts[1] +
+                    (int64_t)scaledMatrix[row][2] * counts[2];
+
+      // Round to the nearest uG
+      *results[row] = (int32_t)((sum + 32768) >> 16);
+    }
+  }
+
+  // Converts a frame to calibrated fields in uG.
+  void apply(const SFE_MMC5983MA_Frame &frame, int32_t *x, int32_t *y, int32_t *z) const
+  {
+    apply(frame.x, frame.y, frame.z, x, y, z);
+  }
+};
+
+#endif
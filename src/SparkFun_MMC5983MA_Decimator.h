@@ -0,0 +1,170 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a streaming decimator: a cascaded integrator-comb (CIC) filter of Order
+  stages which turns every Factor input frames into one averaged output frame. Order 1 is a
+  plain boxcar average; higher orders reject more of the noise and interference above the
+  output rate, at the cost of a longer delay (Order * (Factor - 1) / 2 input samples).
+
+  The filter runs in 32-bit integer arithmetic with 2 * Order words of state per axis. The
+  integrators wrap, which the combs undo exactly, as long as Factor^Order is at most 16384
+  (so the sum of 18-bit inputs fits in 32 bits). Outputs are rounded, 18-bit raw frames, so they
+  can go straight into the calibration, heading and fitting stages. For example, 1000Hz
+  continuous mode with Factor 10 gives 100Hz frames with about 1/3 of the noise.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_DECIMATOR_
+#define _SPARKFUN_MMC5983MA_DECIMATOR_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+
+template <uint8_t Order = 1>
+class SFE_MMC5983MA_Decimator
+{
+  static_assert((Order >= 1) && (Order <= 4), "Order must be 1 to 4");
+
+private:
+  // Factor^Order, the DC gain, must keep the sums of 18-bit inputs within 32 bits
+  static const uint32_t MAX_GAIN = 16384;
+
+  // Unsigned, so the integrators wrap without undefined behaviour
+  uint32_t integrators[3][Order];
+  uint32_t combs[3][Order]; // The previous input to each comb stage
+
+  uint16_t factor = 1;
+  uint16_t phase = 0; // Inputs since the last output
+  uint8_t warmup = 0; // Outputs still to discard while the combs fill
+  uint32_t gain = 1;
+  uint8_t gainShift = 0; // log2(gain) if gain is a power of two, else 0xFF
+
+public:
+  SFE_MMC5983MA_Decimator(uint16_t decimationFactor = 10)
+  {
+    if (!setFactor(decimationFactor))
+      setFactor(1);
+  }
+
+  // Sets the decimation factor and restarts the filter.
+  // Returns false (leaving the factor unchanged) if it is 0 or Factor^Order is above 16384.
+  bool setFactor(uint16_t decimationFactor)
+  {
+    if (decimationFactor == 0)
+      return false;
+
+    uint32_t newGain = 1;
+    for (uint8_t stage = 0; stage < Order; stage++)
+    {
+      newGain *= decimationFactor;
+      if (newGain > MAX_GAIN)
+        return false;
+    }
+
+    factor = decimationFactor;
+    gain = newGain;
+    gainShift = 0xFF;
+    for (uint8_t shift = 0; shift <= 14; shift++)
+    {
+      if (gain == (1UL << shift))
+        gainShift = shift;
+    }
+
+    reset();
+    return true;
+  }
+
+  uint16_t getFactor() const
+  {
+    return factor;
+  }
+
+  // Clears the filter state. The next Order * Factor inputs give the first output.
+  void reset()
+  {
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+      for (uint8_t stage = 0; stage < Order; stage++)
+      {
+        integrators[axis][stage] = 0;
+        combs[axis][stage] = 0;
+      }
+    }
+    phase = 0;
+    warmup = Order - 1;
+  }
+
+  // Adds an input frame (e.g. from readFrame() or a sampler). Returns true, and fills output,
+  // every Factor inputs. The temperature and status of output are those of the last input.
+  // output is left untouched when it returns false.
+  bool push(const SFE_MMC5983MA_Frame &input, SFE_MMC5983MA_Frame *output)
+  {
+    const uint32_t fields[3] = {input.x, input.y, input.z};
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+      uint32_t value = fields[axis];
+      for (uint8_t stage = 0; stage < Order; stage++)
+      {
+        integrators[axis][stage] += value;
+        value = integrators[axis][stage];
+      }
+    }
+
+    if (++phase < factor)
+      return false;
+    phase = 0;
+
+    uint32_t results[3];
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+      uint32_t value = integrators[axis][Order - 1];
+      for (uint8_t stage = 0; stage < Order; stage++)
+      {
+        uint32_t previous = combs[axis][stage];
+        combs[axis][stage] = value;
+        value -= previous;
+      }
+
+      // value is now Factor^Order times the weighted average: round it back to 18 bits
+      if (gainShift != 0xFF)
+        results[axis] = (gainShift == 0) ? value : ((value + (1UL << (gainShift - 1))) >> gainShift);
+      else
+        results[axis] = (value + (gain / 2)) / gain;
+    }
+
+    // The first Order - 1 outputs only see part of the filter's window
+    if (warmup > 0)
+    {
+      warmup--;
+      return false;
+    }
+
+    output->x = results[0];
+    output->y = results[1];
+    output->z = results[2];
+    output->temperature = input.temperature;
+    output->status = input.status;
+    return true;
+  }
+
+  // Filters count input frames, e.g. a batch drained from a sampler, into outputs.
+  // outputs needs room for count / Factor + 1 frames. Returns the number of output frames.
+  uint16_t process(const SFE_MMC5983MA_Frame *inputs, uint16_t count, SFE_MMC5983MA_Frame *outputs)
+  {
+    uint16_t produced = 0;
+    for (uint16_t i = 0; i < count; i++)
+    {
+      if (push(inputs[i], &outputs[produced]))
+        produced++;
+    }
+    return produced;
+  }
+};
+
+#endif
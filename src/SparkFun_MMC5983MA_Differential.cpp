@@ -0,0 +1,169 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements the SET/RESET differential acquisition mode.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Differential.h"
+
+// Mid-scale of the 18-bit fields
+static const int32_t MID_SCALE = 131072;
+
+// Offset differences are well within 2^18, so a larger filter shift would never move the offset
+static const uint8_t MAX_OFFSET_FILTER_SHIFT = 16;
+
+void SFE_MMC5983MA_Differential::setEstimateInterval(uint16_t samples)
+{
+    estimateInterval = samples;
+}
+
+void SFE_MMC5983MA_Differential::setTemperatureThreshold(uint8_t degrees, uint16_t checkInterval)
+{
+    temperatureThreshold = degrees;
+    temperatureCheckInterval = checkInterval;
+    samplesSinceTemperatureCheck = 0;
+}
+
+void SFE_MMC5983MA_Differential::setOffsetFilter(uint8_t shift)
+{
+    offsetFilterShift = (shift > MAX_OFFSET_FILTER_SHIFT) ? MAX_OFFSET_FILTER_SHIFT : shift;
+}
+
+void SFE_MMC5983MA_Differential::setSettlingTime(uint16_t duration)
+{
+    settleMicros = duration;
+}
+
+bool SFE_MMC5983MA_Differential::measure(uint32_t *values)
+{
+    if (!_mag->startMeasurement())
+        return false;
+
+    bool done = _mag->waitUntilMeasurementReady();
+
+    // The raw SET and RESET reads are not samples: keep them away from the frame sinks
+    return (_mag->readFields(&values[0], &values[1], &values[2]) && done);
+}
+
+bool SFE_MMC5983MA_Differential::estimate(uint32_t *values, bool replace)
+{
+    uint32_t resetValues[3];
+    uint32_t setValues[3];
+
+    // Automatic SET/RESET runs a SET before every measurement, so the RESET measurement would read +H too
+    if (_mag->isAutomaticSetResetEnabled())
+        return false;
+
+    // RESET first, so the sensor ends up in the SET state used between estimates
+    if (!_mag->performResetOperation(settleMicros) || !measure(resetValues))
+        return false;
+    if (!_mag->performSetOperation(settleMicros) || !measure(setValues))
+        return false;
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        // SET = +H + offset, RESET = -H + offset
+        int32_t sum = (int32_t)setValues[i] + (int32_t)resetValues[i];
+        int32_t difference = (int32_t)setValues[i] - (int32_t)resetValues[i];
+
+        int32_t newOffset = (sum / 2) - MID_SCALE;
+        if (replace || !offsetValid)
+            offset[i] = newOffset;
+        else
+            offset[i] += (newOffset - offset[i]) / (1L << offsetFilterShift);
+
+        values[i] = (uint32_t)((difference / 2) + MID_SCALE);
+    }
+
+    if (temperatureThreshold > 0)
+    {
+        int temperature = _mag->getTemperature();
+        if (temperature != -99)
+            estimateTemperature = temperature;
+    }
+
+    offsetValid = true;
+    samplesSinceEstimate = 0;
+    samplesSinceTemperatureCheck = 0;
+    estimateCount++;
+    return true;
+}
+
+bool SFE_MMC5983MA_Differential::temperatureChanged()
+{
+    if ((temperatureThreshold == 0) || (samplesSinceTemperatureCheck < temperatureCheckInterval))
+        return false;
+
+    samplesSinceTemperatureCheck = 0;
+
+    int temperature = _mag->getTemperature();
+    if (temperature == -99)
+        return false;
+
+    int change = temperature - estimateTemperature;
+    if (change < 0)
+        change = -change;
+    return (change >= temperatureThreshold);
+}
+
+bool SFE_MMC5983MA_Differential::estimateOffset()
+{
+    uint32_t values[3];
+    return estimate(values, true);
+}
+
+bool SFE_MMC5983MA_Differential::getMeasurementXYZ(uint32_t *x, uint32_t *y, uint32_t *z)
+{
+    uint32_t values[3] = {0, 0, 0};
+    bool success;
+
+    if (!offsetValid || temperatureChanged())
+    {
+        success = estimate(values, true);
+    }
+    else if ((estimateInterval > 0) && (samplesSinceEstimate >= estimateInterval))
+    {
+        success = estimate(values, false);
+    }
+    else
+    {
+        success = measure(values);
+        for (uint8_t i = 0; i < 3; i++)
+            values[i] = (uint32_t)((int32_t)values[i] - offset[i]);
+        samplesSinceEstimate++;
+        samplesSinceTemperatureCheck++;
+    }
+
+    // The frame sinks get the offset-free sample
+    if (success)
+        _mag->publishFields(values[0], values[1], values[2]);
+
+    *x = values[0];
+    *y = values[1];
+    *z = values[2];
+    return success;
+}
+
+void SFE_MMC5983MA_Differential::getOffset(int32_t *x, int32_t *y, int32_t *z)
+{
+    *x = offset[0];
+    *y = offset[1];
+    *z = offset[2];
+}
+
+bool SFE_MMC5983MA_Differential::isOffsetValid()
+{
+    return offsetValid;
+}
+
+uint32_t SFE_MMC5983MA_Differential::getEstimateCount()
+{
+    return estimateCount;
+}
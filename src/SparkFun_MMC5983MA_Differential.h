@@ -0,0 +1,97 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares the SET/RESET differential acquisition mode. A SET and a RESET
+  measurement give the bridge offset: (SET + RESET) / 2. The offset is estimated now
+  and then (every N samples, or when the temperature changes) and subtracted from the
+  single-shot measurements taken in between, in the SET state. Samples are delivered
+  at close to the single-shot rate, without the bridge offset.
+
+  Automatic set/reset must be disabled while this mode is in use: estimates fail while it is enabled.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_DIFFERENTIAL_
+#define _SPARKFUN_MMC5983MA_DIFFERENTIAL_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+
+class SFE_MMC5983MA_Differential
+{
+private:
+  SFE_MMC5983MA *_mag;
+
+  // Schedule. See setEstimateInterval() and setTemperatureThreshold().
+  uint16_t estimateInterval = 100;
+  uint8_t temperatureThreshold = 0;
+  uint16_t temperatureCheckInterval = 0;
+  uint8_t offsetFilterShift = 0;
+  uint16_t settleMicros = 1;
+
+  // Offset in counts, relative to mid-scale (131072)
+  int32_t offset[3] = {0, 0, 0};
+  bool offsetValid = false;
+
+  // Samples since the last estimate and the last temperature check
+  uint16_t samplesSinceEstimate = 0;
+  uint16_t samplesSinceTemperatureCheck = 0;
+
+  // Temperature (in degrees C) at the last estimate
+  int estimateTemperature = 0;
+
+  uint32_t estimateCount = 0;
+
+  // Triggers a measurement, waits for it and reads it
+  bool measure(uint32_t *values);
+
+  // Runs a RESET and a SET measurement, updates the offset and returns the offset-free field.
+  // replace forces the new estimate to replace the running one, instead of being filtered into it.
+  bool estimate(uint32_t *values, bool replace);
+
+  // Returns true if the temperature has moved by temperatureThreshold since the last estimate
+  bool temperatureChanged();
+
+public:
+  SFE_MMC5983MA_Differential(SFE_MMC5983MA &mag) : _mag(&mag) {}
+
+  // Re-estimates the offset every samples measurements. Defaults to 100 (2 extra measurements per 100).
+  // 0 re-estimates only on a temperature change or a call to estimateOffset().
+  void setEstimateInterval(uint16_t samples);
+
+  // Re-estimates the offset when the temperature has moved by degrees since the last estimate.
+  // The temperature is measured every checkInterval samples. degrees = 0 (the default) disables this.
+  void setTemperatureThreshold(uint8_t degrees, uint16_t checkInterval = 100);
+
+  // Filters the offset estimates: each estimate moves the offset 1/2^shift of the way. shift is limited to 16.
+  // Defaults to 0: each estimate replaces the offset. Temperature triggered estimates always replace it.
+  void setOffsetFilter(uint8_t shift);
+
+  // Time to wait after each SET and RESET operation. Defaults to 1us (the operation takes 500ns).
+  void setSettlingTime(uint16_t duration);
+
+  // Runs an estimate now. The sensor is left in the SET state.
+  // Estimates fail while automatic SET/RESET is enabled (see disableAutomaticSetReset()).
+  bool estimateOffset();
+
+  // Measures the field and removes the offset. Runs an estimate first if one is due.
+  // The results have the same scale as getMeasurementXYZ(): 131072 is zero field.
+  // Only the offset-free result is passed to the driver's frame sinks.
+  bool getMeasurementXYZ(uint32_t *x, uint32_t *y, uint32_t *z);
+
+  // Returns the current offset estimate, in counts relative to mid-scale
+  void getOffset(int32_t *x, int32_t *y, int32_t *z);
+
+  // Returns true once the offset has been estimated
+  bool isOffsetValid();
+
+  // Number of estimates run so far
+  uint32_t getEstimateCount();
+};
+
+#endif
@@ -0,0 +1,367 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements the streaming hard/soft-iron calibrator.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_EllipsoidFit.h"
+#include <math.h>
+
+// Mid-scale of the 18-bit fields
+static const int32_t MID_SCALE = 131072;
+
+// The fit is made in Gauss, which keeps the sums well scaled
+static const double COUNTS_PER_GAUSS = 16384.0;
+
+// Samples only count towards the coverage once every axis has spanned at least +/-0.1 Gauss,
+// so noise on a stationary sensor cannot fill the directions
+static const int32_t MINIMUM_HALF_RANGE = 1638;
+
+static const uint8_t DIRECTIONS = 26;
+
+SFE_MMC5983MA_EllipsoidFit::SFE_MMC5983MA_EllipsoidFit()
+{
+    reset();
+}
+
+void SFE_MMC5983MA_EllipsoidFit::reset()
+{
+    reset(0, 0, 0);
+}
+
+void SFE_MMC5983MA_EllipsoidFit::reset(int32_t originX, int32_t originY, int32_t originZ)
+{
+    for (uint8_t i = 0; i < (PARAMETERS * (PARAMETERS + 1) / 2); i++)
+        normalMatrix[i] = 0.0;
+    for (uint8_t i = 0; i < PARAMETERS; i++)
+        normalVector[i] = 0.0;
+    sampleCount = 0;
+
+    origin[0] = originX;
+    origin[1] = originY;
+    origin[2] = originZ;
+
+    visitedDirections = 0;
+    solved = false;
+}
+
+uint8_t SFE_MMC5983MA_EllipsoidFit::upperIndex(uint8_t row, uint8_t column)
+{
+    // Row r of the upper triangle starts after r * PARAMETERS - r * (r - 1) / 2 elements
+    return (uint8_t)((row * PARAMETERS) - ((row * (row - 1)) / 2) + (column - row));
+}
+
+void SFE_MMC5983MA_EllipsoidFit::addSample(uint32_t rawX, uint32_t rawY, uint32_t rawZ)
+{
+    const int32_t counts[3] = {(int32_t)rawX - MID_SCALE, (int32_t)rawY - MID_SCALE, (int32_t)rawZ - MID_SCALE};
+
+    // Coverage
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        if ((sampleCount == 0) || (counts[axis] < minimum[axis]))
+            minimum[axis] = counts[axis];
+        if ((sampleCount == 0) || (counts[axis] > maximum[axis]))
+            maximum[axis] = counts[axis];
+    }
+
+    uint8_t direction = 0;
+    bool classified = true;
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        int32_t halfRange = (maximum[axis] - minimum[axis]) / 2;
+        int32_t position = counts[axis] - ((maximum[axis] + minimum[axis]) / 2);
+
+        if (halfRange < MINIMUM_HALF_RANGE)
+            classified = false;
+
+        // -1, 0 or +1 on each axis: 27 cells, less the centre
+        uint8_t cell = 1;
+        if (position > (halfRange / 2))
+            cell = 2;
+        else if (position < -(halfRange / 2))
+            cell = 0;
+        direction = (uint8_t)((direction * 3) + cell);
+    }
+    if (classified && (direction != 13))
+        visitedDirections |= 1UL << (direction > 13 ? direction - 1 : direction);
+
+    // Normal equations
+    const double x = (double)(counts[0] - origin[0]) / COUNTS_PER_GAUSS;
+    const double y = (double)(counts[1] - origin[1]) / COUNTS_PER_GAUSS;
+    const double z = (double)(counts[2] - origin[2]) / COUNTS_PER_GAUSS;
+    const double design[PARAMETERS] = {x * x, y * y, z * z, 2.0 * x * y, 2.0 * x * z, 2.0 * y * z, 2.0 * x, 2.0 * y, 2.0 * z};
+
+    uint8_t index = 0;
+    for (uint8_t row = 0; row < PARAMETERS; row++)
+    {
+        for (uint8_t column = row; column < PARAMETERS; column++)
+            normalMatrix[index++] += design[row] * design[column];
+        normalVector[row] += design[row];
+    }
+
+    sampleCount++;
+    solved = false;
+}
+
+void SFE_MMC5983MA_EllipsoidFit::addSample(const SFE_MMC5983MA_Frame &frame)
+{
+    addSample(frame.x, frame.y, frame.z);
+}
+
+uint32_t SFE_MMC5983MA_EllipsoidFit::getSampleCount()
+{
+    return sampleCount;
+}
+
+uint8_t SFE_MMC5983MA_EllipsoidFit::getCoverage()
+{
+    uint8_t visited = 0;
+    for (uint8_t i = 0; i < DIRECTIONS; i++)
+    {
+        if (visitedDirections & (1UL << i))
+            visited++;
+    }
+    return (uint8_t)((visited * 100U) / DIRECTIONS);
+}
+
+bool SFE_MMC5983MA_EllipsoidFit::solveNormalEquations(double *parameters)
+{
+    // Cholesky factorisation, L * L^T, of the normal matrix. L overwrites a copy of the lower triangle.
+    double factor[PARAMETERS][PARAMETERS];
+
+    for (uint8_t column = 0; column < PARAMETERS; column++)
+    {
+        for (uint8_t row = column; row < PARAMETERS; row++)
+        {
+            double sum = normalMatrix[upperIndex(column, row)];
+            for (uint8_t k = 0; k < column; k++)
+                sum -= factor[row][k] * factor[column][k];
+
+            if (row == column)
+            {
+                // Not positive definite: the samples do not pin down an ellipsoid
+                if (!(sum > normalMatrix[upperIndex(column, column)] * 1e-12))
+                    return false;
+                factor[column][column] = sqrt(sum);
+            }
+            else
+                factor[row][column] = sum / factor[column][column];
+        }
+    }
+
+    // Forward substitution: L * w = b
+    for (uint8_t row = 0; row < PARAMETERS; row++)
+    {
+        double sum = normalVector[row];
+        for (uint8_t k = 0; k < row; k++)
+            sum -= factor[row][k] * parameters[k];
+        parameters[row] = sum / factor[row][row];
+    }
+
+    // Back substitution: L^T * p = w
+    for (int8_t row = PARAMETERS - 1; row >= 0; row--)
+    {
+        double sum = parameters[row];
+        for (uint8_t k = row + 1; k < PARAMETERS; k++)
+            sum -= factor[k][row] * parameters[k];
+        parameters[row] = sum / factor[row][row];
+    }
+
+    return true;
+}
+
+void SFE_MMC5983MA_EllipsoidFit::jacobiEigen(double matrix[3][3], double vectors[3][3])
+{
+    for (uint8_t row = 0; row < 3; row++)
+    {
+        for (uint8_t column = 0; column < 3; column++)
+            vectors[row][column] = (row == column) ? 1.0 : 0.0;
+    }
+
+    // Cyclic sweeps. A 3x3 matrix converges to machine precision in a handful.
+    for (uint8_t sweep = 0; sweep < 16; sweep++)
+    {
+        double offDiagonal = fabs(matrix[0][1]) + fabs(matrix[0][2]) + fabs(matrix[1][2]);
+        double diagonal = fabs(matrix[0][0]) + fabs(matrix[1][1]) + fabs(matrix[2][2]);
+        if (offDiagonal <= diagonal * 1e-15)
+            break;
+
+        for (uint8_t p = 0; p < 2; p++)
+        {
+            for (uint8_t q = p + 1; q < 3; q++)
+            {
+                if (matrix[p][q] == 0.0)
+                    continue;
+
+                // Rotation angle which zeroes matrix[p][q]
+                double theta = (matrix[q][q] - matrix[p][p]) / (2.0 * matrix[p][q]);
+                double t = 1.0 / (fabs(theta) + sqrt((theta * theta) + 1.0));
+                if (theta < 0.0)
+                    t = -t;
+                double c = 1.0 / sqrt((t * t) + 1.0);
+                double s = t * c;
+
+                // matrix = R^T * matrix * R, vectors = vectors * R
+                for (uint8_t k = 0; k < 3; k++)
+                {
+                    double kp = matrix[k][p];
+                    double kq = matrix[k][q];
+                    matrix[k][p] = (c * kp) - (s * kq);
+                    matrix[k][q] = (s * kp) + (c * kq);
+                }
+                for (uint8_t k = 0; k < 3; k++)
+                {
+                    double pk = matrix[p][k];
+                    double qk = matrix[q][k];
+                    matrix[p][k] = (c * pk) - (s * qk);
+                    matrix[q][k] = (s * pk) + (c * qk);
+                }
+                for (uint8_t k = 0; k < 3; k++)
+                {
+                    double kp = vectors[k][p];
+                    double kq = vectors[k][q];
+                    vectors[k][p] = (c * kp) - (s * kq);
+                    vectors[k][q] = (s * kp) + (c * kq);
+                }
+            }
+        }
+    }
+}
+
+bool SFE_MMC5983MA_EllipsoidFit::solve()
+{
+    solved = false;
+
+    if (sampleCount < PARAMETERS)
+        return false;
+
+    double parameters[PARAMETERS];
+    if (!solveNormalEquations(parameters))
+        return false;
+
+    // x^T A x + 2 b^T x = 1
+    double shape[3][3] = {{parameters[0], parameters[3], parameters[4]},
+                          {parameters[3], parameters[1], parameters[5]},
+                          {parameters[4], parameters[5], parameters[2]}};
+    const double linear[3] = {parameters[6], parameters[7], parameters[8]};
+
+    // A = V * diag(eigenvalues) * V^T
+    double vectors[3][3];
+    jacobiEigen(shape, vectors);
+    const double eigenvalues[3] = {shape[0][0], shape[1][1], shape[2][2]};
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (eigenvalues[i] == 0.0)
+            return false;
+    }
+
+    // Centre c = -A^-1 b. Then (x - c)^T A (x - c) = 1 - b^T c = k.
+    double projected[3];
+    for (uint8_t i = 0; i < 3; i++)
+        projected[i] = ((vectors[0][i] * linear[0]) + (vectors[1][i] * linear[1]) + (vectors[2][i] * linear[2])) / eigenvalues[i];
+    double fitCenter[3];
+    for (uint8_t axis = 0; axis < 3; axis++)
+        fitCenter[axis] = -((vectors[axis][0] * projected[0]) + (vectors[axis][1] * projected[1]) + (vectors[axis][2] * projected[2]));
+
+    double k = 1.0 - ((linear[0] * fitCenter[0]) + (linear[1] * fitCenter[1]) + (linear[2] * fitCenter[2]));
+
+    // A / k must be positive definite for an ellipsoid. (A and k are both negative when the origin is outside it.)
+    double normalized[3];
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        normalized[i] = eigenvalues[i] / k;
+        if (!(normalized[i] > 0.0))
+            return false;
+    }
+
+    // Semi-axes are 1 / sqrt(normalized). Scale the corrected sphere to their geometric mean, so the mean
+    // field strength is kept: W = R * V * diag(sqrt(normalized)) * V^T maps the ellipsoid to radius R.
+    double fitRadius = 1.0 / cbrt(sqrt(normalized[0] * normalized[1] * normalized[2]));
+    double gains[3];
+    for (uint8_t i = 0; i < 3; i++)
+        gains[i] = fitRadius * sqrt(normalized[i]);
+
+    for (uint8_t row = 0; row < 3; row++)
+    {
+        for (uint8_t column = 0; column < 3; column++)
+        {
+            softIron[row][column] = (vectors[row][0] * gains[0] * vectors[column][0]) +
+                                    (vectors[row][1] * gains[1] * vectors[column][1]) +
+                                    (vectors[row][2] * gains[2] * vectors[column][2]);
+        }
+    }
+
+    // Residual sum of squares, from the sums: p^T M p - 2 p^T b + n.
+    // Each residual is (x - c)^T A (x - c) - k, which is about 2k times the relative radius error.
+    double squares = (double)sampleCount;
+    for (uint8_t row = 0; row < PARAMETERS; row++)
+    {
+        double product = 0.0;
+        for (uint8_t column = 0; column < PARAMETERS; column++)
+            product += normalMatrix[row <= column ? upperIndex(row, column) : upperIndex(column, row)] * parameters[column];
+        squares += parameters[row] * (product - (2.0 * normalVector[row]));
+    }
+    if (squares < 0.0)
+        squares = 0.0;
+    fitError = sqrt(squares / (double)sampleCount) / (2.0 * fabs(k));
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+        center[axis] = (fitCenter[axis] * COUNTS_PER_GAUSS) + (double)origin[axis];
+    radius = fitRadius * COUNTS_PER_GAUSS;
+
+    solved = true;
+    return true;
+}
+
+double SFE_MMC5983MA_EllipsoidFit::getFitError()
+{
+    return solved ? fitError : 0.0;
+}
+
+double SFE_MMC5983MA_EllipsoidFit::getFieldStrength()
+{
+    return solved ? radius : 0.0;
+}
+
+void SFE_MMC5983MA_EllipsoidFit::getOffset(int32_t *x, int32_t *y, int32_t *z)
+{
+    int32_t *const results[3] = {x, y, z};
+    for (uint8_t axis = 0; axis < 3; axis++)
+        *results[axis] = solved ? (int32_t)lround(center[axis]) : 0;
+}
+
+void SFE_MMC5983MA_EllipsoidFit::getMatrix(int32_t q16Matrix[3][3])
+{
+    for (uint8_t row = 0; row < 3; row++)
+    {
+        for (uint8_t column = 0; column < 3; column++)
+        {
+            if (solved)
+                q16Matrix[row][column] = (int32_t)lround(softIron[row][column] * 65536.0);
+            else
+                q16Matrix[row][column] = (row == column) ? 65536 : 0;
+        }
+    }
+}
+
+bool SFE_MMC5983MA_EllipsoidFit::applyTo(SFE_MMC5983MA_Calibration &calibration)
+{
+    if (!solved)
+        return false;
+
+    int32_t x, y, z;
+    getOffset(&x, &y, &z);
+    calibration.setOffset(x, y, z);
+
+    int32_t q16Matrix[3][3];
+    getMatrix(q16Matrix);
+    calibration.setMatrix(q16Matrix);
+    return true;
+}
@@ -0,0 +1,102 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a streaming hard/soft-iron calibrator. Raw samples are taken one at a time
+  into the normal equations of a least squares ellipsoid fit:
+
+    a x^2 + b y^2 + c z^2 + 2d xy + 2e xz + 2f yz + 2g x + 2h y + 2i z = 1
+
+  Only the 9x9 normal matrix and its right hand side are kept, so memory use does not grow with
+  the number of samples. solve() returns the ellipsoid centre (the hard-iron offset) and the
+  symmetric matrix which maps the ellipsoid back to a sphere (the soft-iron correction), ready
+  for SFE_MMC5983MA_Calibration. Note: on AVR, double is 32 bits, so the fit is less precise.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_ELLIPSOID_FIT_
+#define _SPARKFUN_MMC5983MA_ELLIPSOID_FIT_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+#include "SparkFun_MMC5983MA_Calibration.h"
+
+class SFE_MMC5983MA_EllipsoidFit
+{
+private:
+  static const uint8_t PARAMETERS = 9;
+
+  // Upper triangle of sum(D * D^T), row by row, and sum(D), for D = (x^2, y^2, z^2, 2xy, 2xz, 2yz, 2x, 2y, 2z)
+  double normalMatrix[PARAMETERS * (PARAMETERS + 1) / 2];
+  double normalVector[PARAMETERS];
+  uint32_t sampleCount;
+
+  // The samples are taken relative to this point (counts, relative to mid-scale). See reset().
+  int32_t origin[3];
+
+  // Coverage: the range seen on each axis (in counts) and the directions visited
+  int32_t minimum[3];
+  int32_t maximum[3];
+  uint32_t visitedDirections;
+
+  // Results of solve()
+  bool solved;
+  double center[3];     // Counts, relative to mid-scale
+  double softIron[3][3]; // Dimensionless
+  double radius;        // Counts
+  double fitError;      // Relative RMS radius error
+
+  static uint8_t upperIndex(uint8_t row, uint8_t column);
+
+  // Solves the normal equations (Cholesky). Returns false if they are singular.
+  bool solveNormalEquations(double *parameters);
+
+  // Eigen-decomposition of a symmetric 3x3 matrix by Jacobi rotations.
+  // On return, matrix is diagonal (the eigenvalues) and vectors holds the eigenvectors in its columns.
+  static void jacobiEigen(double matrix[3][3], double vectors[3][3]);
+
+public:
+  SFE_MMC5983MA_EllipsoidFit();
+
+  // Forgets all the samples. The fit is made about mid-scale.
+  void reset();
+
+  // Forgets all the samples. The fit is made about the given point, in counts relative to mid-scale.
+  // The fit is badly conditioned if this point lies on the ellipsoid itself (a hard-iron offset close to
+  // the field strength), so when recalibrating pass the previous offset (SFE_MMC5983MA_Calibration::getOffset()).
+  void reset(int32_t originX, int32_t originY, int32_t originZ);
+
+  // Adds a raw sample (e.g. from readFieldsXYZ())
+  void addSample(uint32_t rawX, uint32_t rawY, uint32_t rawZ);
+  void addSample(const SFE_MMC5983MA_Frame &frame);
+
+  uint32_t getSampleCount();
+
+  // Percentage (0 to 100) of 26 directions (cube faces, edges and corners) in which samples have been seen,
+  // relative to the middle of the range seen so far. Aim for 80% or more before calling solve().
+  uint8_t getCoverage();
+
+  // Fits the ellipsoid. Returns false if there are too few samples or the fit is not an ellipsoid.
+  bool solve();
+
+  // After solve(): RMS error of the samples from the fitted ellipsoid, relative to its radius (0.01 = 1%).
+  double getFitError();
+
+  // After solve(): the mean field strength, in counts (16384 counts per Gauss).
+  double getFieldStrength();
+
+  // After solve(): the hard-iron offset in counts, relative to mid-scale.
+  void getOffset(int32_t *x, int32_t *y, int32_t *z);
+
+  // After solve(): the soft-iron matrix in Q16 (1.0 = 65536). It preserves the mean field strength.
+  void getMatrix(int32_t q16Matrix[3][3]);
+
+  // After solve(): sets the offset and matrix of a calibration stage. Returns false if solve() has not succeeded.
+  bool applyTo(SFE_MMC5983MA_Calibration &calibration);
+};
+
+#endif
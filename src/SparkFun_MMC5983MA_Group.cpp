@@ -0,0 +1,104 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements a group of MMC5983MA sensors which are triggered and read together.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Group.h"
+
+SFE_MMC5983MA_Group::SFE_MMC5983MA_Group(SFE_MMC5983MA *sensors[], uint8_t count) : _sensors(sensors), _count(count)
+{
+}
+
+uint8_t SFE_MMC5983MA_Group::getCount()
+{
+    return _count;
+}
+
+void SFE_MMC5983MA_Group::beginSweep()
+{
+#ifdef SFE_MMC5983MA_USE_SPI
+    // The first sensor starts the transaction, the others share it.
+    for (uint8_t i = 0; i < _count; i++)
+        _sensors[i]->beginSPITransaction(i == 0);
+#endif
+}
+
+void SFE_MMC5983MA_Group::endSweep()
+{
+#ifdef SFE_MMC5983MA_USE_SPI
+    // Release in reverse order so the owner ends the transaction last.
+    for (uint8_t i = _count; i > 0; i--)
+        _sensors[i - 1]->endSPITransaction();
+#endif
+}
+
+bool SFE_MMC5983MA_Group::triggerAll()
+{
+    bool success = true;
+
+    beginSweep();
+    for (uint8_t i = 0; i < _count; i++)
+        success &= _sensors[i]->startMeasurement();
+    endSweep();
+
+    if (_count > 0)
+    {
+        firstTriggerMicros = _sensors[0]->getMeasurementStartTime();
+        lastTriggerMicros = _sensors[_count - 1]->getMeasurementStartTime();
+    }
+
+    return success;
+}
+
+bool SFE_MMC5983MA_Group::isReady()
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (!_sensors[i]->isMeasurementReady())
+            return false;
+    }
+    return true;
+}
+
+bool SFE_MMC5983MA_Group::readAll(SFE_MMC5983MA_Frame *frames)
+{
+    bool success = true;
+
+    beginSweep();
+    for (uint8_t i = 0; i < _count; i++)
+        success &= _sensors[i]->readFrame(&frames[i]);
+    endSweep();
+
+    return success;
+}
+
+bool SFE_MMC5983MA_Group::measureAll(SFE_MMC5983MA_Frame *frames)
+{
+    if (!triggerAll())
+        return false;
+
+    // The sensors were triggered in order, so the first one is done first
+    bool success = true;
+    for (uint8_t i = 0; i < _count; i++)
+        success &= _sensors[i]->waitUntilMeasurementReady();
+
+    return readAll(frames) && success;
+}
+
+uint32_t SFE_MMC5983MA_Group::getTriggerTime()
+{
+    return firstTriggerMicros;
+}
+
+uint32_t SFE_MMC5983MA_Group::getTriggerSkew()
+{
+    return lastTriggerMicros - firstTriggerMicros;
+}
@@ -0,0 +1,65 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a group of MMC5983MA sensors which are triggered and read together,
+  e.g. for gradiometer arrays. When the sensors share an SPI bus each sweep runs inside a
+  single SPI transaction, so the measurements are started back to back with minimal skew.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_GROUP_
+#define _SPARKFUN_MMC5983MA_GROUP_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+
+class SFE_MMC5983MA_Group
+{
+private:
+  // The array of sensors is owned by the caller and must outlive the group.
+  SFE_MMC5983MA **_sensors;
+  uint8_t _count;
+
+  // Trigger time of the first and the last sensor in the most recent triggerAll().
+  uint32_t firstTriggerMicros = 0;
+  uint32_t lastTriggerMicros = 0;
+
+  // Opens one SPI transaction shared by all sensors. Has no effect on I2C.
+  void beginSweep();
+
+  // Ends the transaction opened by beginSweep().
+  void endSweep();
+
+public:
+  // All sensors must already have been started with begin().
+  SFE_MMC5983MA_Group(SFE_MMC5983MA *sensors[], uint8_t count);
+
+  uint8_t getCount();
+
+  // Starts a measurement on every sensor, back to back.
+  // Returns false if any of the triggers failed.
+  bool triggerAll();
+
+  // Returns true when the measurements started by triggerAll() are complete on every sensor.
+  bool isReady();
+
+  // Reads one frame per sensor into frames[], which must hold getCount() entries.
+  // Returns false if any of the reads failed.
+  bool readAll(SFE_MMC5983MA_Frame *frames);
+
+  // Triggers all sensors, waits for them and reads one frame per sensor.
+  bool measureAll(SFE_MMC5983MA_Frame *frames);
+
+  // Time (in microseconds) at which the first sensor was triggered by triggerAll().
+  uint32_t getTriggerTime();
+
+  // Time (in microseconds) between the first and the last trigger of triggerAll().
+  uint32_t getTriggerSkew();
+};
+
+#endif
@@ -0,0 +1,218 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements the integer heading kernel.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Heading.h"
+
+// Mid-scale of the 18-bit fields
+static const int32_t MID_SCALE = 131072;
+
+// Angles in hundredths of a degree
+static const int32_t QUARTER_TURN = 9000;
+static const int32_t HALF_TURN = 18000;
+static const int32_t FULL_TURN = 36000;
+
+// The octant ratio is Q15. The polynomials give hundredths of a degree in Q3, so every
+// coefficient is below 2^16 and every product fits in 32 bits.
+static const uint8_t RATIO_SHIFT = 15;
+static const uint8_t RESULT_SHIFT = 3;
+
+// atan(r) = r * (pi/4 + (1 - r) * (0.2447 + 0.0663 r)), expanded
+static const int32_t FAST_COEFFICIENTS[3] = {47216, -8177, -3039};
+
+// atan(r) = r * (0.9998660 - 0.3302995 r^2 + 0.1801410 r^4 - 0.0851330 r^6 + 0.0208351 r^8)
+static const int32_t PRECISE_COEFFICIENTS[5] = {45830, -15140, 8257, -3902, 955};
+
+// Squared length of a vector of 16-bit values: at most 3 * 2^30
+static inline uint32_t lengthSquared(const int32_t vector[3])
+{
+    return (uint32_t)(vector[0] * vector[0]) + (uint32_t)(vector[1] * vector[1]) + (uint32_t)(vector[2] * vector[2]);
+}
+
+// Length of a vector from its squared length, rounded to the nearest integer
+static inline uint32_t roundedLength(uint32_t squared)
+{
+    uint32_t root = SFE_MMC5983MA_Heading::squareRoot(squared);
+
+    // The true root is root + 1/2 or more exactly when squared > root^2 + root
+    if ((squared - (root * root)) > root)
+        root++;
+    return root;
+}
+
+// Arc tangent of ratio (Q15, 0 to 1) in hundredths of a degree, 0 to 4500
+static inline int32_t octantArcTangent(int32_t ratio, SFE_MMC5983MA_HeadingAccuracy accuracy)
+{
+    int32_t result;
+
+    if (accuracy == SFE_MMC5983MA_HeadingAccuracy::FAST)
+    {
+        result = FAST_COEFFICIENTS[2];
+        result = FAST_COEFFICIENTS[1] + ((result * ratio) >> RATIO_SHIFT);
+        result = FAST_COEFFICIENTS[0] + ((result * ratio) >> RATIO_SHIFT);
+    }
+    else
+    {
+        int32_t squared = (ratio * ratio) >> RATIO_SHIFT;
+        result = PRECISE_COEFFICIENTS[4];
+        result = PRECISE_COEFFICIENTS[3] + ((result * squared) >> RATIO_SHIFT);
+        result = PRECISE_COEFFICIENTS[2] + ((result * squared) >> RATIO_SHIFT);
+        result = PRECISE_COEFFICIENTS[1] + ((result * squared) >> RATIO_SHIFT);
+        result = PRECISE_COEFFICIENTS[0] + ((result * squared) >> RATIO_SHIFT);
+    }
+
+    result = (result * ratio) >> RATIO_SHIFT;
+    return (result + (1 << (RESULT_SHIFT - 1))) >> RESULT_SHIFT;
+}
+
+int16_t SFE_MMC5983MA_Heading::arcTangent(int32_t y, int32_t x, SFE_MMC5983MA_HeadingAccuracy accuracy)
+{
+    uint32_t absoluteX = (x < 0) ? (0UL - (uint32_t)x) : (uint32_t)x;
+    uint32_t absoluteY = (y < 0) ? (0UL - (uint32_t)y) : (uint32_t)y;
+
+    // Reduce to the first octant
+    bool swapped = absoluteY > absoluteX;
+    uint32_t larger = swapped ? absoluteY : absoluteX;
+    uint32_t smaller = swapped ? absoluteX : absoluteY;
+    if (larger == 0)
+        return 0;
+
+    // Keep (smaller << 15) within 31 bits
+    while (larger >= (1UL << 16))
+    {
+        larger >>= 1;
+        smaller >>= 1;
+    }
+    int32_t ratio = (int32_t)(((smaller << RATIO_SHIFT) + (larger / 2)) / larger);
+
+    int32_t angle = octantArcTangent(ratio, accuracy);
+    if (swapped)
+        angle = QUARTER_TURN - angle;
+    if (x < 0)
+        angle = HALF_TURN - angle;
+    if (y < 0)
+        angle = -angle;
+    return (int16_t)angle;
+}
+
+int16_t SFE_MMC5983MA_Heading::arcTangent64(int64_t y, int64_t x, SFE_MMC5983MA_HeadingAccuracy accuracy)
+{
+    // Scale both down to 31 bits. Only the ratio matters.
+    while ((x > INT32_MAX) || (x < -INT32_MAX) || (y > INT32_MAX) || (y < -INT32_MAX))
+    {
+        x /= 2;
+        y /= 2;
+    }
+    return arcTangent((int32_t)y, (int32_t)x, accuracy);
+}
+
+uint32_t SFE_MMC5983MA_Heading::squareRoot(uint32_t value)
+{
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value)
+        bit >>= 2;
+
+    // One result bit per step
+    while (bit != 0)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+            result >>= 1;
+        bit >>= 2;
+    }
+    return result;
+}
+
+uint16_t SFE_MMC5983MA_Heading::getHeading(int32_t x, int32_t y, SFE_MMC5983MA_HeadingAccuracy accuracy)
+{
+    // atan2(x, -y) + 180 degrees, i.e. atan2(-x, y) wrapped to 0 to 360 degrees
+    int32_t heading = arcTangent((x == INT32_MIN) ? INT32_MAX : -x, y, accuracy);
+    if (heading < 0)
+        heading += FULL_TURN;
+    if (heading >= FULL_TURN)
+        heading -= FULL_TURN;
+    return (uint16_t)heading;
+}
+
+uint16_t SFE_MMC5983MA_Heading::tiltHeading(int32_t x, int32_t y, int32_t z, const int32_t gravity[3],
+                                            uint32_t gravitySquared, uint32_t gravityLength, SFE_MMC5983MA_HeadingAccuracy accuracy)
+{
+    // With g the unit gravity vector, the horizontal reference directions are
+    //   e1 = -Y projected onto the horizontal plane = -Y + (Y.g) g, and e2 = g x e1 = X when level,
+    // and heading = atan2(B.e2, B.e1). Scaled to integers, with G = |gravity|:
+    //   B.e2 * G^2 = G * (Bx gz - Bz gx) and B.e1 * G^2 = gy (B.gravity) - G^2 By.
+    // Dividing both by G^2 leaves one division (by G) for B.e1. G is rounded to the nearest integer,
+    // so B.e1 is scaled by up to 1 +/- 0.5 / G, which turns the heading by up to 0.25 / G radians.
+    int64_t dot = ((int64_t)x * gravity[0]) + ((int64_t)y * gravity[1]) + ((int64_t)z * gravity[2]);
+    int64_t east = ((int64_t)x * gravity[2]) - ((int64_t)z * gravity[0]);
+    int64_t north = (((int64_t)gravity[1] * dot) - ((int64_t)gravitySquared * y)) / (int64_t)gravityLength;
+
+    // Same convention as getHeading(x, y): atan2(B.e2, B.e1) + 180 degrees
+    int32_t heading = arcTangent64(-east, -north, accuracy);
+    if (heading < 0)
+        heading += FULL_TURN;
+    if (heading >= FULL_TURN)
+        heading -= FULL_TURN;
+    return (uint16_t)heading;
+}
+
+uint16_t SFE_MMC5983MA_Heading::getHeading(int32_t x, int32_t y, int32_t z, const int16_t gravity[3], SFE_MMC5983MA_HeadingAccuracy accuracy)
+{
+    const int32_t vector[3] = {gravity[0], gravity[1], gravity[2]};
+    uint32_t gravitySquared = lengthSquared(vector);
+    if (gravitySquared == 0)
+        return getHeading(x, y, accuracy);
+
+    return tiltHeading(x, y, z, vector, gravitySquared, roundedLength(gravitySquared), accuracy);
+}
+
+void SFE_MMC5983MA_Heading::getHeadings(const SFE_MMC5983MA_Frame *frames, uint16_t *headings, uint16_t count,
+                                        const SFE_MMC5983MA_Calibration *calibration, const int16_t *gravity,
+                                        SFE_MMC5983MA_HeadingAccuracy accuracy)
+{
+    // The gravity length is worked out once for the whole batch
+    int32_t vector[3] = {0, 0, 0};
+    uint32_t gravitySquared = 0;
+    uint32_t gravityLength = 0;
+    if (gravity != nullptr)
+    {
+        vector[0] = gravity[0];
+        vector[1] = gravity[1];
+        vector[2] = gravity[2];
+        gravitySquared = lengthSquared(vector);
+        gravityLength = roundedLength(gravitySquared);
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        int32_t x, y, z;
+        if (calibration != nullptr)
+            calibration->apply(frames[i], &x, &y, &z);
+        else
+        {
+            x = (int32_t)frames[i].x - MID_SCALE;
+            y = (int32_t)frames[i].y - MID_SCALE;
+            z = (int32_t)frames[i].z - MID_SCALE;
+        }
+
+        if (gravitySquared == 0)
+            headings[i] = getHeading(x, y, accuracy);
+        else
+            headings[i] = tiltHeading(x, y, z, vector, gravitySquared, gravityLength, accuracy);
+    }
+}
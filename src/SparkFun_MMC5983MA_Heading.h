@@ -0,0 +1,69 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares an integer heading kernel. Headings are in hundredths of a degree, using the
+  same convention as Example2: atan2(x, -y) + 180 degrees, with magnetic north along the Y axis.
+
+  The arc tangent is a polynomial in fixed point, after reducing the angle to the first octant:
+    FAST:    3rd order, maximum error 0.1 degrees
+    PRECISE: 9th order, maximum error 0.01 degrees (the output resolution)
+  Tilt compensation takes a gravity vector from an accelerometer, in any units, with its axes aligned
+  with the magnetometer's. It is the acceleration measured at rest, i.e. (0, 0, +1g) when the sensor is flat.
+  Its length is rounded to an integer, which adds up to 14.3 / |gravity| degrees of error. Keeping that below
+  the arc tangent's own error needs |gravity| of at least 1433 for PRECISE (144 for FAST), e.g. an
+  accelerometer reading 2048 counts per g or more.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_HEADING_
+#define _SPARKFUN_MMC5983MA_HEADING_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+#include "SparkFun_MMC5983MA_Calibration.h"
+
+enum class SFE_MMC5983MA_HeadingAccuracy : uint8_t
+{
+  FAST,
+  PRECISE
+};
+
+class SFE_MMC5983MA_Heading
+{
+private:
+  // Arc tangent of y / x for large values (e.g. the tilt-compensated components)
+  static int16_t arcTangent64(int64_t y, int64_t x, SFE_MMC5983MA_HeadingAccuracy accuracy);
+
+  // Tilt-compensated heading, for gravity with squared length gravitySquared and length gravityLength
+  static uint16_t tiltHeading(int32_t x, int32_t y, int32_t z, const int32_t gravity[3],
+                              uint32_t gravitySquared, uint32_t gravityLength, SFE_MMC5983MA_HeadingAccuracy accuracy);
+
+public:
+  // Arc tangent of y / x in hundredths of a degree, -18000 to +18000. Returns 0 if both are 0.
+  static int16_t arcTangent(int32_t y, int32_t x, SFE_MMC5983MA_HeadingAccuracy accuracy = SFE_MMC5983MA_HeadingAccuracy::PRECISE);
+
+  // Integer square root, rounded down
+  static uint32_t squareRoot(uint32_t value);
+
+  // Heading (0 to 35999 hundredths of a degree) from signed fields, e.g. calibrated fields in uG
+  // or raw fields less 131072. The sensor must be level.
+  static uint16_t getHeading(int32_t x, int32_t y, SFE_MMC5983MA_HeadingAccuracy accuracy = SFE_MMC5983MA_HeadingAccuracy::PRECISE);
+
+  // Tilt-compensated heading from signed fields (up to +/-2^23) and a gravity vector (see above).
+  // Falls back to the level heading if gravity is zero.
+  static uint16_t getHeading(int32_t x, int32_t y, int32_t z, const int16_t gravity[3],
+                             SFE_MMC5983MA_HeadingAccuracy accuracy = SFE_MMC5983MA_HeadingAccuracy::PRECISE);
+
+  // Headings for count buffered raw frames. The frames are calibrated first if calibration is given,
+  // otherwise only mid-scale is removed. They are tilt-compensated if gravity is given.
+  static void getHeadings(const SFE_MMC5983MA_Frame *frames, uint16_t *headings, uint16_t count,
+                          const SFE_MMC5983MA_Calibration *calibration = nullptr, const int16_t *gravity = nullptr,
+                          SFE_MMC5983MA_HeadingAccuracy accuracy = SFE_MMC5983MA_HeadingAccuracy::PRECISE);
+};
+
+#endif
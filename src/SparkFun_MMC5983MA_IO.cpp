@@ -15,171 +15,63 @@
 #include "SparkFun_MMC5983MA_IO.h"
 #include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
 
-// Read operations must have the most significant bit set
-#define READ_REG(x) (0x80 | x)
-
+#ifdef SFE_MMC5983MA_USE_I2C
 bool SFE_MMC5983MA_IO::begin(TwoWire &i2cPort)
 {
     useSPI = false;
-    _i2cPort = &i2cPort;
+    bus = nullptr;
+    i2c.begin(i2cPort);
     return isConnected();
 }
+#endif
 
-void SFE_MMC5983MA_IO::initSPISettings()
+#ifdef SFE_MMC5983MA_USE_SPI
+SPISettings SFE_MMC5983MA_IO::initSPISettings()
 {
     // CPOL = 1, CPHA = 1 : SPI Mode 3 according to datasheet
     //  In practice SPI_MODE0 is what worked.
-    _mmcSpiSettings = SPISettings(2000000, MSBFIRST, SPI_MODE0);
+    return SPISettings(2000000, MSBFIRST, SPI_MODE0);
 }
 
 bool SFE_MMC5983MA_IO::begin(const uint8_t csPin, SPIClass &spiPort)
 {
-    useSPI = true;
-    _csPin = csPin;
-    digitalWrite(_csPin, HIGH);
-    pinMode(_csPin, OUTPUT);
-    _spiPort = &spiPort;
-
-    initSPISettings();
-
-    return isConnected();
+    return begin(csPin, initSPISettings(), spiPort);
 }
 
 bool SFE_MMC5983MA_IO::begin(const uint8_t csPin, SPISettings userSettings, SPIClass &spiPort)
 {
     useSPI = true;
-    _csPin = csPin;
-    digitalWrite(_csPin, HIGH);
-    pinMode(_csPin, OUTPUT);
-    _spiPort = &spiPort;
-
-    _mmcSpiSettings = userSettings;
-
+    bus = nullptr;
+    spi.begin(csPin, userSettings, spiPort);
     return isConnected();
 }
+#endif
 
-bool SFE_MMC5983MA_IO::isConnected()
-{
-    bool result;
-    if (useSPI)
-    {
-        _spiPort->beginTransaction(_mmcSpiSettings);
-        digitalWrite(_csPin, LOW);
-        _spiPort->transfer(READ_REG(PROD_ID_REG));
-        uint8_t readback = _spiPort->transfer(DUMMY);
-        digitalWrite(_csPin, HIGH);
-        _spiPort->endTransaction();
-        result = (readback == PROD_ID);
-    }
-    else
-    {
-        _i2cPort->beginTransmission(I2C_ADDR);
-        result = (_i2cPort->endTransmission() == 0);
-        if (result)
-        {
-            uint8_t id = 0;
-            result &= readSingleByte(PROD_ID_REG, &id);
-            result &= id == PROD_ID;
-        }
-    }
-    return result;
-}
-
-bool SFE_MMC5983MA_IO::writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, uint8_t const packetLength)
-{
-    bool success = true;
-    if (useSPI)
-    {
-        _spiPort->beginTransaction(_mmcSpiSettings);
-        digitalWrite(_csPin, LOW);
-        _spiPort->transfer(registerAddress);
-        _spiPort->transfer(buffer, packetLength);
-        digitalWrite(_csPin, HIGH);
-        _spiPort->endTransaction();
-    }
-    else
-    {
-        _i2cPort->beginTransmission(I2C_ADDR);
-        _i2cPort->write(registerAddress);
-        for (uint8_t i = 0; i < packetLength; i++)
-            _i2cPort->write(buffer[i]);
-        success = _i2cPort->endTransmission() == 0;
-    }
-    return success;
-}
-
-bool SFE_MMC5983MA_IO::readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+#ifdef SFE_MMC5983MA_USE_BUS
+bool SFE_MMC5983MA_IO::begin(SFE_MMC5983MA_Bus &busBackend)
 {
-    bool success = true;
-    if (useSPI)
-    {
-        _spiPort->beginTransaction(_mmcSpiSettings);
-        digitalWrite(_csPin, LOW);
-        _spiPort->transfer(READ_REG(registerAddress));
-        _spiPort->transfer(buffer, packetLength);
-        digitalWrite(_csPin, HIGH);
-        _spiPort->endTransaction();
-    }
-    else
-    {
-        _i2cPort->beginTransmission(I2C_ADDR);
-        _i2cPort->write(registerAddress);
-        success = _i2cPort->endTransmission() == 0;
-
-        uint8_t returned = _i2cPort->requestFrom(I2C_ADDR, packetLength);
-        for (uint8_t i = 0; (i < packetLength) && (i < returned); i++)
-            buffer[i] = _i2cPort->read();
-        success &= returned == packetLength;
-    }
-    return success;
-}
-
-bool SFE_MMC5983MA_IO::readSingleByte(const uint8_t registerAddress, uint8_t *buffer)
-{
-    bool success = true;
-    if (useSPI)
-    {
-        _spiPort->beginTransaction(_mmcSpiSettings);
-        digitalWrite(_csPin, LOW);
-        _spiPort->transfer(READ_REG(registerAddress));
-        *buffer = _spiPort->transfer(DUMMY);
-        digitalWrite(_csPin, HIGH);
-        _spiPort->endTransaction();
-    }
-    else
-    {
-        _i2cPort->beginTransmission(I2C_ADDR);
-        _i2cPort->write(registerAddress);
-        success = _i2cPort->endTransmission() == 0;
-        
-        uint8_t returned = _i2cPort->requestFrom(I2C_ADDR, 1U);
-        if (returned == 1)
-            *buffer = _i2cPort->read();
-        success &= returned == 1;
-    }
-    return success;
+    useSPI = false;
+    bus = &busBackend;
+    return isConnected();
 }
+#endif
 
-bool SFE_MMC5983MA_IO::writeSingleByte(const uint8_t registerAddress, const uint8_t value)
+void SFE_MMC5983MA_IO::waitMicros(uint32_t duration)
 {
-    bool success = true;
-    if (useSPI)
+#ifdef SFE_MMC5983MA_USE_BUS
+    if (bus != nullptr)
     {
-        _spiPort->beginTransaction(_mmcSpiSettings);
-        digitalWrite(_csPin, LOW);
-        _spiPort->transfer(registerAddress);
-        _spiPort->transfer(value);
-        digitalWrite(_csPin, HIGH);
-        _spiPort->endTransaction();
+        bus->waitMicros(duration);
+        return;
     }
-    else
-    {
-        _i2cPort->beginTransmission(I2C_ADDR);
-        _i2cPort->write(registerAddress);
-        _i2cPort->write(value);
-        success = _i2cPort->endTransmission() == 0;
-    }
-    return success;
+#endif
+#ifndef SFE_MMC5983MA_BUS_ONLY
+    // delayMicroseconds is only accurate up to ~16ms on some platforms
+    if (duration >= 1000)
+        delay(duration / 1000);
+    if ((duration % 1000) > 0)
+        delayMicroseconds(duration % 1000);
+#endif
 }
 
 bool SFE_MMC5983MA_IO::setRegisterBit(const uint8_t registerAddress, const uint8_t bitMask)
@@ -206,8 +98,3 @@ bool SFE_MMC5983MA_IO::isBitSet(const uint8_t registerAddress, const uint8_t bit
     readSingleByte(registerAddress, &value);
     return (value & bitMask);
 }
-
-bool SFE_MMC5983MA_IO::spiInUse()
-{
-    return useSPI;
-}
@@ -15,21 +15,54 @@
 #ifndef _SPARKFUN_MMC5983MA_IO_
 #define _SPARKFUN_MMC5983MA_IO_
 
-#include <Arduino.h>
-#include <Wire.h>
-#include <SPI.h>
+#include "SparkFun_MMC5983MA_Transport.h"
+#include "SparkFun_MMC5983MA_Stats.h"
+
+// Dispatches a call to the transport in use. When only one bus is compiled in, the
+// call goes straight to that transport and there is no run time branch.
+#if defined(SFE_MMC5983MA_SPI_ONLY)
+#define SFE_MMC5983MA_DISPATCH(call) (spi.call)
+#elif defined(SFE_MMC5983MA_I2C_ONLY)
+#define SFE_MMC5983MA_DISPATCH(call) (i2c.call)
+#elif defined(SFE_MMC5983MA_BUS_ONLY)
+#define SFE_MMC5983MA_DISPATCH(call) (bus->call)
+#else
+#define SFE_MMC5983MA_DISPATCH(call) (bus != nullptr ? bus->call : (useSPI ? spi.call : i2c.call))
+#endif
+
+// Records a bus transaction, if statistics are enabled
+#ifdef SFE_MMC5983MA_ENABLE_STATS
+#define SFE_MMC5983MA_RECORD_TRANSACTION(read, written, success) recordTransaction(read, written, success)
+#else
+#define SFE_MMC5983MA_RECORD_TRANSACTION(read, written, success)
+#endif
 
 class SFE_MMC5983MA_IO
 {
 private:
-  SPIClass *_spiPort = nullptr;
-  uint8_t _csPin = 0;
-  SPISettings _mmcSpiSettings;
-
-  TwoWire *_i2cPort = nullptr;
-  uint8_t _address = 0;
+  // The members do not depend on the bus flags, only the code using them does
+#ifdef ARDUINO
+  SFE_MMC5983MA_SPI_Transport spi;
+  SFE_MMC5983MA_I2C_Transport i2c;
+#endif
+  SFE_MMC5983MA_Bus *bus = nullptr;
   bool useSPI = false;
 
+  // Where the bus statistics are recorded, if anywhere. See setBusStats().
+  SFE_MMC5983MA_BusStats *busStats = nullptr;
+
+  void recordTransaction(uint8_t bytesRead, uint8_t bytesWritten, bool success)
+  {
+    if (busStats == nullptr)
+      return;
+
+    busStats->transactions++;
+    busStats->bytesRead += bytesRead;
+    busStats->bytesWritten += bytesWritten;
+    if (!success)
+      busStats->failures++;
+  }
+
 public:
   // Default empty constructor.
   SFE_MMC5983MA_IO() = default;
@@ -37,32 +70,87 @@ public:
   // Default empty destructor
   ~SFE_MMC5983MA_IO() = default;
 
-  // Builds default SPI settings if none are provided.
-  void initSPISettings();
-
+#ifdef SFE_MMC5983MA_USE_I2C
   // Configures and starts the I2C I/O layer.
   bool begin(TwoWire &wirePort);
 
+  // Selects I2C repeated START reads. See SFE_MMC5983MA_I2C_Transport.
+  void setI2CRepeatedStart(bool enable)
+  {
+    i2c.setRepeatedStart(enable);
+  }
+#endif
+
+#ifdef SFE_MMC5983MA_USE_SPI
+  // Builds default SPI settings if none are provided.
+  static SPISettings initSPISettings();
+
   // Configures and starts the SPI I/O layer.
   bool begin(const uint8_t csPin, SPIClass &spiPort = SPI);
 
   // Configures the SPI I/O layer with the given chip select and SPI settings provided by the user.
   bool begin(const uint8_t csPin, SPISettings userSettings, SPIClass &spiPort = SPI);
 
+  // Holds one SPI transaction open across calls. See SFE_MMC5983MA_SPI_Transport.
+  void holdSPITransaction(bool ownTransaction)
+  {
+    if (useSPI)
+      spi.holdTransaction(ownTransaction);
+  }
+
+  // Ends a transaction started by holdSPITransaction()
+  void releaseSPITransaction()
+  {
+    if (useSPI)
+      spi.releaseTransaction();
+  }
+#endif
+
+#ifdef SFE_MMC5983MA_USE_BUS
+  // Configures the I/O layer to use a custom bus backend.
+  bool begin(SFE_MMC5983MA_Bus &busBackend);
+#endif
+
   // Returns true if we get the correct product ID from the device.
-  bool isConnected();
+  bool isConnected()
+  {
+    // A product ID read
+    bool success = SFE_MMC5983MA_DISPATCH(isConnected());
+    SFE_MMC5983MA_RECORD_TRANSACTION(1, 0, success);
+    return success;
+  }
 
   // Read a single uint8_t from a register.
-  bool readSingleByte(const uint8_t registerAddress, uint8_t *buffer);
+  bool readSingleByte(const uint8_t registerAddress, uint8_t *buffer)
+  {
+    bool success = SFE_MMC5983MA_DISPATCH(readSingleByte(registerAddress, buffer));
+    SFE_MMC5983MA_RECORD_TRANSACTION(1, 0, success);
+    return success;
+  }
 
   // Writes a single uint8_t into a register.
-  bool writeSingleByte(const uint8_t registerAddress, const uint8_t value);
+  bool writeSingleByte(const uint8_t registerAddress, const uint8_t value)
+  {
+    bool success = SFE_MMC5983MA_DISPATCH(writeSingleByte(registerAddress, value));
+    SFE_MMC5983MA_RECORD_TRANSACTION(0, 1, success);
+    return success;
+  }
 
   // Reads multiple bytes from a register into buffer uint8_t array.
-  bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength);
+  bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+  {
+    bool success = SFE_MMC5983MA_DISPATCH(readMultipleBytes(registerAddress, buffer, packetLength));
+    SFE_MMC5983MA_RECORD_TRANSACTION(packetLength, 0, success);
+    return success;
+  }
 
   // Writes multiple bytes to register from buffer uint8_t array.
-  bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength);
+  bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+  {
+    bool success = SFE_MMC5983MA_DISPATCH(writeMultipleBytes(registerAddress, buffer, packetLength));
+    SFE_MMC5983MA_RECORD_TRANSACTION(0, packetLength, success);
+    return success;
+  }
 
   // Sets a single bit in a specific register. Bit position ranges from 0 (lsb) to 7 (msb).
   bool setRegisterBit(const uint8_t registerAddress, const uint8_t bitMask);
@@ -74,7 +162,40 @@ public:
   bool isBitSet(const uint8_t registerAddress, const uint8_t bitMask);
 
   // Returns true if the interface in use is SPI
-  bool spiInUse();
+  bool spiInUse()
+  {
+    return useSPI;
+  }
+
+  // Returns a free-running microsecond count from the time base of the bus in use.
+  uint32_t getMicros()
+  {
+#if defined(SFE_MMC5983MA_BUS_ONLY)
+    return bus->getMicros();
+#elif defined(SFE_MMC5983MA_USE_BUS)
+    if (bus != nullptr)
+      return bus->getMicros();
+    return micros();
+#else
+    return micros();
+#endif
+  }
+
+  // Waits for the given number of microseconds using the time base of the bus in use.
+  void waitMicros(uint32_t duration);
+
+  // Records the bus statistics into storage (nullptr stops recording). Only with SFE_MMC5983MA_ENABLE_STATS.
+  void setBusStats(SFE_MMC5983MA_BusStats *storage)
+  {
+    busStats = storage;
+  }
+
+  // Counts a measurement which did not complete before its timeout
+  void recordTimeout()
+  {
+    if (busStats != nullptr)
+      busStats->timeouts++;
+  }
 };
 
 #endif
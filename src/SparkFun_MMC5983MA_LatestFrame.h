@@ -0,0 +1,126 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a latest-sample slot protected by a sequence lock. One acquisition context
+  (an ISR, or the task which reads the sensor) publishes each frame, with a timestamp and a
+  sequence number; any number of readers (other tasks or threads, or loop()) take consistent
+  snapshots without touching the bus and without ever blocking the publisher. A reader which
+  overlaps a publish sees the sequence lock change and tries again.
+
+  Attach it to the driver with addFrameSink(), or call publish() directly. Only one context may publish.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_LATEST_FRAME_
+#define _SPARKFUN_MMC5983MA_LATEST_FRAME_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+
+// The sequence lock must be read and written in a single access: on 8-bit AVR that means a single byte.
+// (A reader would then need to be held up for 128 publishes to miss a change.)
+#if defined(__AVR__)
+typedef uint8_t sfe_mmc5983ma_seqlock_t;
+#else
+typedef uint32_t sfe_mmc5983ma_seqlock_t;
+#endif
+
+// A published frame
+struct SFE_MMC5983MA_Sample
+{
+  SFE_MMC5983MA_Frame frame;
+  uint32_t timestamp = 0; // Microseconds, from the bus time base
+  uint32_t sequence = 0;  // 1 for the first frame published, then counts up
+};
+
+class SFE_MMC5983MA_LatestFrame : public SFE_MMC5983MA_FrameSink
+{
+private:
+  static const uint8_t WORDS = 6;
+
+  // Odd while a publish is in progress
+  volatile sfe_mmc5983ma_seqlock_t version = 0;
+
+  // The sample, as x, y, z, temperature | status << 8, timestamp, sequence.
+  // Copied word by word: a torn copy is caught by the version check.
+  volatile uint32_t words[WORDS] = {0, 0, 0, 0, 0, 0};
+
+  // Only used by the publisher
+  uint32_t published = 0;
+
+public:
+  // Publisher: stores a frame read at timestamp. Never waits.
+  void publish(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp)
+  {
+    sfe_mmc5983ma_seqlock_t currentVersion = version;
+
+    version = currentVersion + 1;
+    __atomic_thread_fence(__ATOMIC_RELEASE); // The odd version must be visible before any of the words change
+
+    words[0] = frame.x;
+    words[1] = frame.y;
+    words[2] = frame.z;
+    words[3] = (uint32_t)frame.temperature | ((uint32_t)frame.status << 8);
+    words[4] = timestamp;
+    words[5] = ++published;
+
+    __atomic_thread_fence(__ATOMIC_RELEASE); // Publish the words before the even version
+    version = currentVersion + 2;
+  }
+
+  // Driver hook: see SFE_MMC5983MA::addFrameSink()
+  void onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp) override
+  {
+    publish(frame, timestamp);
+  }
+
+  // Reader: takes a single snapshot attempt, so it always finishes in bounded time.
+  // Returns false if it overlapped a publish, or nothing has been published yet.
+  bool tryRead(SFE_MMC5983MA_Sample *sample) const
+  {
+    sfe_mmc5983ma_seqlock_t startVersion = version;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // Read the version before the words
+
+    if (startVersion & 1)
+      return false;
+
+    uint32_t copy[WORDS];
+    for (uint8_t i = 0; i < WORDS; i++)
+      copy[i] = words[i];
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // Read the words before checking the version again
+    if (version != startVersion)
+      return false;
+
+    if (copy[5] == 0)
+      return false;
+
+    sample->frame.x = copy[0];
+    sample->frame.y = copy[1];
+    sample->frame.z = copy[2];
+    sample->frame.temperature = (uint8_t)copy[3];
+    sample->frame.status = (uint8_t)(copy[3] >> 8);
+    sample->timestamp = copy[4];
+    sample->sequence = copy[5];
+    return true;
+  }
+
+  // Reader: retries until it gets a consistent snapshot. Returns false if nothing has been published yet.
+  // Do not call from an interrupt which can preempt the publisher: it would never see the publish finish.
+  bool read(SFE_MMC5983MA_Sample *sample) const
+  {
+    if (words[5] == 0)
+      return false;
+
+    while (!tryRead(sample))
+      ;
+    return true;
+  }
+};
+
+#endif
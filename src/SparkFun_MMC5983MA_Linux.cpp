@@ -0,0 +1,192 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements Linux userspace bus backends for /dev/spidevX.Y and /dev/i2c-N.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Linux.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <linux/spi/spidev.h>
+
+int SFE_MMC5983MA_LinuxFile::openDevice(const char *path)
+{
+    return open(path, O_RDWR);
+}
+
+int SFE_MMC5983MA_LinuxFile::closeDevice(int fd)
+{
+    return close(fd);
+}
+
+int SFE_MMC5983MA_LinuxFile::ioctlDevice(int fd, unsigned long request, void *argument)
+{
+    return ioctl(fd, request, argument);
+}
+
+SFE_MMC5983MA_LinuxBus::SFE_MMC5983MA_LinuxBus(SFE_MMC5983MA_LinuxFile *fileBackend)
+{
+    file = (fileBackend != nullptr) ? fileBackend : &defaultFile;
+}
+
+SFE_MMC5983MA_LinuxBus::~SFE_MMC5983MA_LinuxBus()
+{
+    end();
+}
+
+bool SFE_MMC5983MA_LinuxBus::openDevice(const char *device)
+{
+    end();
+    fd = file->openDevice(device);
+    return (fd >= 0);
+}
+
+void SFE_MMC5983MA_LinuxBus::end()
+{
+    if (fd >= 0)
+        file->closeDevice(fd);
+    fd = -1;
+}
+
+uint32_t SFE_MMC5983MA_LinuxBus::getMicros()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000ULL) + ((uint64_t)now.tv_nsec / 1000ULL));
+}
+
+void SFE_MMC5983MA_LinuxBus::waitMicros(uint32_t duration)
+{
+    struct timespec request;
+    request.tv_sec = duration / 1000000UL;
+    request.tv_nsec = (long)(duration % 1000000UL) * 1000L;
+
+    // Resume the sleep if a signal interrupts it. Any other error (e.g. EINVAL) would repeat forever, so give up.
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &request, &request) == EINTR)
+        ;
+}
+
+bool SFE_MMC5983MA_LinuxSPI::begin(const char *device, uint32_t speedHz, uint8_t mode)
+{
+    if (!openDevice(device))
+        return false;
+
+    _speedHz = speedHz;
+    uint8_t bits = 8;
+
+    bool success = file->ioctlDevice(fd, SPI_IOC_WR_MODE, &mode) >= 0;
+    success &= file->ioctlDevice(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) >= 0;
+    success &= file->ioctlDevice(fd, SPI_IOC_WR_MAX_SPEED_HZ, &speedHz) >= 0;
+
+    if (!success)
+        end();
+
+    return success;
+}
+
+bool SFE_MMC5983MA_LinuxSPI::transfer(uint8_t *txBuffer, uint8_t *rxBuffer, uint16_t length)
+{
+    struct spi_ioc_transfer message;
+    memset(&message, 0, sizeof(message));
+    message.tx_buf = (unsigned long)txBuffer;
+    message.rx_buf = (unsigned long)rxBuffer;
+    message.len = length;
+    message.speed_hz = _speedHz;
+    message.bits_per_word = 8;
+
+    // SPI_IOC_MESSAGE returns the number of bytes transferred
+    return (file->ioctlDevice(fd, SPI_IOC_MESSAGE(1), &message) == (int)length);
+}
+
+bool SFE_MMC5983MA_LinuxSPI::readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+{
+    uint8_t txBuffer[256] = {0};
+    uint8_t rxBuffer[256] = {0};
+
+    // Read operations must have the most significant bit set.
+    // The data is clocked in while the dummy bytes are clocked out.
+    txBuffer[0] = 0x80 | registerAddress;
+
+    if (!transfer(txBuffer, rxBuffer, (uint16_t)packetLength + 1))
+        return false;
+
+    memcpy(buffer, &rxBuffer[1], packetLength);
+    return true;
+}
+
+bool SFE_MMC5983MA_LinuxSPI::writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+{
+    uint8_t txBuffer[256];
+
+    txBuffer[0] = registerAddress;
+    memcpy(&txBuffer[1], buffer, packetLength);
+
+    return transfer(txBuffer, nullptr, (uint16_t)packetLength + 1);
+}
+
+bool SFE_MMC5983MA_LinuxI2C::begin(const char *device, uint8_t address)
+{
+    _address = address;
+    return openDevice(device);
+}
+
+bool SFE_MMC5983MA_LinuxI2C::readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+{
+    uint8_t address = registerAddress;
+
+    // Write the register address, then read the data after a repeated start
+    struct i2c_msg messages[2];
+    messages[0].addr = _address;
+    messages[0].flags = 0;
+    messages[0].len = 1;
+    messages[0].buf = &address;
+    messages[1].addr = _address;
+    messages[1].flags = I2C_M_RD;
+    messages[1].len = packetLength;
+    messages[1].buf = buffer;
+
+    struct i2c_rdwr_ioctl_data transaction;
+    transaction.msgs = messages;
+    transaction.nmsgs = 2;
+
+    // I2C_RDWR returns the number of messages transferred
+    return (file->ioctlDevice(fd, I2C_RDWR, &transaction) == 2);
+}
+
+bool SFE_MMC5983MA_LinuxI2C::writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+{
+    uint8_t txBuffer[256];
+
+    txBuffer[0] = registerAddress;
+    memcpy(&txBuffer[1], buffer, packetLength);
+
+    struct i2c_msg message;
+    message.addr = _address;
+    message.flags = 0;
+    message.len = (uint16_t)packetLength + 1;
+    message.buf = txBuffer;
+
+    struct i2c_rdwr_ioctl_data transaction;
+    transaction.msgs = &message;
+    transaction.nmsgs = 1;
+
+    return (file->ioctlDevice(fd, I2C_RDWR, &transaction) == 1);
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares Linux userspace bus backends for /dev/spidevX.Y and /dev/i2c-N.
+  Each register burst is a single ioctl: a full-duplex SPI_IOC_MESSAGE transfer, or a
+  combined (repeated start) I2C_RDWR message pair.
+  The system calls go through SFE_MMC5983MA_LinuxFile, which can be replaced by a fake
+  file descriptor backend to exercise the transports with no device attached.
+  The driver's frame sink list has no lock on Linux: add the sinks (SFE_MMC5983MA::addFrameSink())
+  before starting the thread which reads frames, and remove them after it has stopped.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_LINUX_
+#define _SPARKFUN_MMC5983MA_LINUX_
+
+#if defined(__linux__)
+
+#include "SparkFun_MMC5983MA_Bus.h"
+
+// The system calls used by the Linux transports. Override these to fake a device.
+class SFE_MMC5983MA_LinuxFile
+{
+public:
+  virtual ~SFE_MMC5983MA_LinuxFile() {}
+
+  // Returns a file descriptor, or -1 on error.
+  virtual int openDevice(const char *path);
+
+  // Returns 0 on success, or -1 on error.
+  virtual int closeDevice(int fd);
+
+  // Returns -1 on error.
+  virtual int ioctlDevice(int fd, unsigned long request, void *argument);
+};
+
+// Common file handling and time base for the Linux transports.
+class SFE_MMC5983MA_LinuxBus : public SFE_MMC5983MA_Bus
+{
+protected:
+  SFE_MMC5983MA_LinuxFile defaultFile;
+  SFE_MMC5983MA_LinuxFile *file;
+  int fd = -1;
+
+  // Opens the device, closing any previously opened one first
+  bool openDevice(const char *device);
+
+public:
+  // Uses the real system calls, or the given replacement
+  SFE_MMC5983MA_LinuxBus(SFE_MMC5983MA_LinuxFile *fileBackend = nullptr);
+  ~SFE_MMC5983MA_LinuxBus();
+
+  // Closes the device.
+  void end();
+
+  // CLOCK_MONOTONIC, in microseconds
+  uint32_t getMicros() override;
+
+  void waitMicros(uint32_t duration) override;
+};
+
+class SFE_MMC5983MA_LinuxSPI : public SFE_MMC5983MA_LinuxBus
+{
+private:
+  uint32_t _speedHz = 2000000;
+
+  // Performs a single full-duplex transfer of length bytes
+  bool transfer(uint8_t *txBuffer, uint8_t *rxBuffer, uint16_t length);
+
+public:
+  SFE_MMC5983MA_LinuxSPI(SFE_MMC5983MA_LinuxFile *fileBackend = nullptr) : SFE_MMC5983MA_LinuxBus(fileBackend) {}
+
+  // Opens e.g. /dev/spidev0.0 and configures the SPI mode, word size and clock.
+  // SPI mode 0 is what works in practice (see SFE_MMC5983MA_IO::initSPISettings).
+  bool begin(const char *device, uint32_t speedHz = 2000000, uint8_t mode = 0);
+
+  bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) override;
+  bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) override;
+};
+
+class SFE_MMC5983MA_LinuxI2C : public SFE_MMC5983MA_LinuxBus
+{
+private:
+  uint8_t _address = I2C_ADDR;
+
+public:
+  SFE_MMC5983MA_LinuxI2C(SFE_MMC5983MA_LinuxFile *fileBackend = nullptr) : SFE_MMC5983MA_LinuxBus(fileBackend) {}
+
+  // Opens e.g. /dev/i2c-1.
+  bool begin(const char *device, uint8_t address = I2C_ADDR);
+
+  bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) override;
+  bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) override;
+};
+
+#endif
+
+#endif
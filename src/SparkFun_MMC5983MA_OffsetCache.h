@@ -0,0 +1,189 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a temperature-indexed bridge offset cache. The raw die temperature
+  range (T_OUT, 0 to 255) is split into Bins bins, each holding the average of the offset
+  estimates (e.g. from SFE_MMC5983MA_Differential) made at that temperature. The offset
+  at any temperature is interpolated between the nearest filled bins and applied to raw
+  measurements with three subtractions, so SET/RESET cycles are only needed to fill bins.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_OFFSET_CACHE_
+#define _SPARKFUN_MMC5983MA_OFFSET_CACHE_
+
+#include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
+
+template <uint8_t Bins = 16>
+class SFE_MMC5983MA_OffsetCache
+{
+  static_assert((Bins > 0) && ((256 % Bins) == 0), "Bins must divide 256");
+
+private:
+  static const uint16_t BIN_WIDTH = 256 / Bins;
+
+  // Estimates are averaged over up to this many per bin, so old estimates age out
+  static const uint8_t MAX_AVERAGE = 8;
+
+  struct Bin
+  {
+    int32_t offset[3];
+    uint16_t temperature; // Average raw temperature of the estimates, in 1/16 counts
+    uint8_t count;        // Number of estimates averaged, up to MAX_AVERAGE. 0 = empty
+  };
+
+  Bin bins[Bins];
+
+  // Offset interpolated at the current temperature. See setTemperature().
+  int32_t currentOffset[3] = {0, 0, 0};
+  bool currentValid = false;
+  bool temperatureSet = false; // currentTemperature is only meaningful once setTemperature() has been called
+  uint8_t currentTemperature = 0;
+
+  static uint8_t binIndex(uint8_t rawTemperature)
+  {
+    return (uint8_t)(rawTemperature / BIN_WIDTH);
+  }
+
+  // Interpolates the offset at rawTemperature (in 1/16 counts) between the nearest filled bins
+  bool interpolate(uint16_t temperature, int32_t *offset) const
+  {
+    const Bin *below = nullptr;
+    const Bin *above = nullptr;
+
+    for (uint8_t i = 0; i < Bins; i++)
+    {
+      const Bin &bin = bins[i];
+      if (bin.count == 0)
+        continue;
+      if (bin.temperature <= temperature)
+      {
+        if ((below == nullptr) || (bin.temperature > below->temperature))
+          below = &bin;
+      }
+      else if ((above == nullptr) || (bin.temperature < above->temperature))
+        above = &bin;
+    }
+
+    // Outside the filled range: use the nearest bin
+    if (below == nullptr)
+      below = above;
+    if (above == nullptr)
+      above = below;
+    if (below == nullptr)
+      return false;
+
+    int32_t span = (int32_t)above->temperature - (int32_t)below->temperature;
+    int32_t position = (int32_t)temperature - (int32_t)below->temperature;
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+      offset[axis] = below->offset[axis];
+      if (span > 0)
+        offset[axis] += (int32_t)(((int64_t)(above->offset[axis] - below->offset[axis]) * position) / span);
+    }
+    return true;
+  }
+
+public:
+  SFE_MMC5983MA_OffsetCache()
+  {
+    clear();
+  }
+
+  // Empties every bin
+  void clear()
+  {
+    for (uint8_t i = 0; i < Bins; i++)
+      bins[i].count = 0;
+    currentValid = false;
+  }
+
+  // Returns true if the bin for rawTemperature has no estimate yet
+  bool needsEstimate(uint8_t rawTemperature) const
+  {
+    return bins[binIndex(rawTemperature)].count == 0;
+  }
+
+  // Adds an offset estimate (in counts, relative to mid-scale) made at rawTemperature.
+  // apply() does not use the cache until setTemperature() has been called.
+  void addEstimate(uint8_t rawTemperature, int32_t x, int32_t y, int32_t z)
+  {
+    Bin &bin = bins[binIndex(rawTemperature)];
+    const int32_t estimate[3] = {x, y, z};
+    uint16_t temperature = (uint16_t)rawTemperature << 4;
+
+    if (bin.count < MAX_AVERAGE)
+      bin.count++;
+
+    // Running average over the last MAX_AVERAGE estimates (or fewer, while the bin fills)
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+      if (bin.count == 1)
+        bin.offset[axis] = estimate[axis];
+      else
+        bin.offset[axis] += (estimate[axis] - bin.offset[axis]) / bin.count;
+    }
+    if (bin.count == 1)
+      bin.temperature = temperature;
+    else
+      bin.temperature = (uint16_t)((int32_t)bin.temperature + ((int32_t)temperature - (int32_t)bin.temperature) / bin.count);
+
+    // Refresh the offset in use, if there is a temperature to use it at
+    if (temperatureSet)
+      setTemperature(currentTemperature);
+  }
+
+  // Returns the offset interpolated at rawTemperature. False if the cache is empty.
+  bool getOffset(uint8_t rawTemperature, int32_t *x, int32_t *y, int32_t *z) const
+  {
+    int32_t offset[3];
+    if (!interpolate((uint16_t)rawTemperature << 4, offset))
+      return false;
+    *x = offset[0];
+    *y = offset[1];
+    *z = offset[2];
+    return true;
+  }
+
+  // Selects the offset applied by apply(). Call whenever a new temperature reading is available.
+  // Returns false if the cache is empty.
+  bool setTemperature(uint8_t rawTemperature)
+  {
+    currentTemperature = rawTemperature;
+    temperatureSet = true;
+    currentValid = interpolate((uint16_t)rawTemperature << 4, currentOffset);
+    return currentValid;
+  }
+
+  // Hot path: removes the offset for the current temperature from raw fields (e.g. from readFieldsXYZ()).
+  // Returns false, leaving the fields unchanged, if the cache is empty or setTemperature() has not been called.
+  bool apply(uint32_t *x, uint32_t *y, uint32_t *z) const
+  {
+    if (!currentValid)
+      return false;
+    *x = (uint32_t)((int32_t)*x - currentOffset[0]);
+    *y = (uint32_t)((int32_t)*y - currentOffset[1]);
+    *z = (uint32_t)((int32_t)*z - currentOffset[2]);
+    return true;
+  }
+
+  // Number of bins holding an estimate
+  uint8_t getFilledBins() const
+  {
+    uint8_t filled = 0;
+    for (uint8_t i = 0; i < Bins; i++)
+    {
+      if (bins[i].count > 0)
+        filled++;
+    }
+    return filled;
+  }
+};
+
+#endif
@@ -0,0 +1,188 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a configuration profile: a precomputed image of the four write-only
+  internal control registers (0x09 to 0x0C). Profiles are built at compile time and applied
+  with a single multi-byte write, e.g.:
+
+    constexpr SFE_MMC5983MA_Profile highRate = SFE_MMC5983MA_Profile()
+                                                 .withFilterBandwidth(800)
+                                                 .withContinuousModeFrequency(1000)
+                                                 .withContinuousMode(true);
+    static_assert(highRate.isValid(), "Invalid profile"); // 1000Hz needs the 800Hz bandwidth
+    myMag.applyProfile(highRate);
+
+  isValid() also catches combinations the datasheet does not allow, so the same profile with
+  .withFilterBandwidth(400) fails the static_assert at compile time.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_PROFILE_
+#define _SPARKFUN_MMC5983MA_PROFILE_
+
+#include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
+
+class SFE_MMC5983MA_Profile
+{
+private:
+  // Marks an encoding which does not match any of the settings in the datasheet
+  static constexpr uint8_t INVALID_ENCODING = 0xff;
+
+  static constexpr uint8_t BW_MASK = BW0 | BW1;
+  static constexpr uint8_t CM_FREQ_MASK = CM_FREQ_2 | CM_FREQ_1 | CM_FREQ_0;
+  static constexpr uint8_t PRD_SET_MASK = PRD_SET_2 | PRD_SET_1 | PRD_SET_0;
+
+  // Register images for INT_CTRL_0_REG to INT_CTRL_3_REG
+  uint8_t control0;
+  uint8_t control1;
+  uint8_t control2;
+  uint8_t control3;
+
+  // False if any of the settings passed to the with...() functions was invalid
+  bool encodingsValid;
+
+  constexpr SFE_MMC5983MA_Profile(uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3, bool valid)
+      : control0(c0), control1(c1), control2(c2), control3(c3), encodingsValid(valid)
+  {
+  }
+
+  static constexpr uint8_t assignBits(uint8_t registerValue, uint8_t bitMask, bool set)
+  {
+    return set ? (uint8_t)(registerValue | bitMask) : (uint8_t)(registerValue & ~bitMask);
+  }
+
+  static constexpr uint8_t replaceBits(uint8_t registerValue, uint8_t fieldMask, uint8_t fieldValue)
+  {
+    return (uint8_t)((registerValue & ~fieldMask) | (fieldValue & fieldMask));
+  }
+
+  static constexpr uint8_t encodeFilterBandwidth(uint16_t bandwidth)
+  {
+    return bandwidth == 100   ? 0
+           : bandwidth == 200 ? BW0
+           : bandwidth == 400 ? BW1
+           : bandwidth == 800 ? (BW1 | BW0)
+                              : INVALID_ENCODING;
+  }
+
+  static constexpr uint8_t encodeContinuousModeFrequency(uint16_t frequency)
+  {
+    return frequency == 0      ? 0
+           : frequency == 1    ? 1
+           : frequency == 10   ? 2
+           : frequency == 20   ? 3
+           : frequency == 50   ? 4
+           : frequency == 100  ? 5
+           : frequency == 200  ? 6
+           : frequency == 1000 ? 7
+                               : INVALID_ENCODING;
+  }
+
+  static constexpr uint8_t encodePeriodicSetSamples(uint16_t numberOfSamples)
+  {
+    return numberOfSamples == 1      ? 0
+           : numberOfSamples == 25   ? 1
+           : numberOfSamples == 75   ? 2
+           : numberOfSamples == 100  ? 3
+           : numberOfSamples == 250  ? 4
+           : numberOfSamples == 500  ? 5
+           : numberOfSamples == 1000 ? 6
+           : numberOfSamples == 2000 ? 7
+                                     : INVALID_ENCODING;
+  }
+
+public:
+  // Power-on defaults: 100Hz bandwidth, continuous mode, interrupt and automatic set/reset disabled.
+  constexpr SFE_MMC5983MA_Profile() : control0(0), control1(0), control2(0), control3(0), encodingsValid(true) {}
+
+  // Builds a profile from raw register images, e.g. one returned by SFE_MMC5983MA::getProfile().
+  // Command bits (TM_M, TM_T, SET, RESET, OTP_READ and SW_RST) are dropped.
+  static constexpr SFE_MMC5983MA_Profile fromRegisters(uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3)
+  {
+    return SFE_MMC5983MA_Profile((uint8_t)(c0 & (INT_MEAS_DONE_EN | AUTO_SR_EN)), (uint8_t)(c1 & ~SW_RST), c2, c3, true);
+  }
+
+  // Filter bandwidth in Hz: 100, 200, 400 or 800.
+  constexpr SFE_MMC5983MA_Profile withFilterBandwidth(uint16_t bandwidth) const
+  {
+    return SFE_MMC5983MA_Profile(control0, replaceBits(control1, BW_MASK, encodeFilterBandwidth(bandwidth)), control2, control3,
+                                 encodingsValid && (encodeFilterBandwidth(bandwidth) != INVALID_ENCODING));
+  }
+
+  // Continuous mode frequency in Hz: 0 (off), 1, 10, 20, 50, 100, 200 or 1000.
+  constexpr SFE_MMC5983MA_Profile withContinuousModeFrequency(uint16_t frequency) const
+  {
+    return SFE_MMC5983MA_Profile(control0, control1, replaceBits(control2, CM_FREQ_MASK, encodeContinuousModeFrequency(frequency)), control3,
+                                 encodingsValid && (encodeContinuousModeFrequency(frequency) != INVALID_ENCODING));
+  }
+
+  // Number of measurements between periodic SET operations: 1, 25, 75, 100, 250, 500, 1000 or 2000.
+  constexpr SFE_MMC5983MA_Profile withPeriodicSetSamples(uint16_t numberOfSamples) const
+  {
+    return SFE_MMC5983MA_Profile(control0, control1, replaceBits(control2, PRD_SET_MASK, (uint8_t)(encodePeriodicSetSamples(numberOfSamples) << 4)), control3,
+                                 encodingsValid && (encodePeriodicSetSamples(numberOfSamples) != INVALID_ENCODING));
+  }
+
+  constexpr SFE_MMC5983MA_Profile withContinuousMode(bool enable) const
+  {
+    return SFE_MMC5983MA_Profile(control0, control1, assignBits(control2, CMM_EN, enable), control3, encodingsValid);
+  }
+
+  constexpr SFE_MMC5983MA_Profile withPeriodicSet(bool enable) const
+  {
+    return SFE_MMC5983MA_Profile(control0, control1, assignBits(control2, EN_PRD_SET, enable), control3, encodingsValid);
+  }
+
+  constexpr SFE_MMC5983MA_Profile withAutomaticSetReset(bool enable) const
+  {
+    return SFE_MMC5983MA_Profile(assignBits(control0, AUTO_SR_EN, enable), control1, control2, control3, encodingsValid);
+  }
+
+  constexpr SFE_MMC5983MA_Profile withInterrupt(bool enable) const
+  {
+    return SFE_MMC5983MA_Profile(assignBits(control0, INT_MEAS_DONE_EN, enable), control1, control2, control3, encodingsValid);
+  }
+
+  constexpr SFE_MMC5983MA_Profile withXChannel(bool enable) const
+  {
+    return SFE_MMC5983MA_Profile(control0, assignBits(control1, X_INHIBIT, !enable), control2, control3, encodingsValid);
+  }
+
+  constexpr SFE_MMC5983MA_Profile withYZChannels(bool enable) const
+  {
+    return SFE_MMC5983MA_Profile(control0, assignBits(control1, YZ_INHIBIT, !enable), control2, control3, encodingsValid);
+  }
+
+  constexpr SFE_MMC5983MA_Profile with3WireSPI(bool enable) const
+  {
+    return SFE_MMC5983MA_Profile(control0, control1, control2, assignBits(control3, SPI_3W, enable), encodingsValid);
+  }
+
+  // True if every setting was valid and the combination is allowed by the datasheet
+  // (periodic set needs both continuous mode and automatic set/reset; a 200Hz continuous mode
+  // frequency needs the 200Hz filter bandwidth and 1000Hz needs the 800Hz bandwidth).
+  constexpr bool isValid() const
+  {
+    return encodingsValid &&
+           (((control2 & EN_PRD_SET) == 0) || (((control2 & CMM_EN) != 0) && ((control0 & AUTO_SR_EN) != 0))) &&
+           (((control2 & CM_FREQ_MASK) != encodeContinuousModeFrequency(200)) || ((control1 & BW_MASK) == encodeFilterBandwidth(200))) &&
+           (((control2 & CM_FREQ_MASK) != encodeContinuousModeFrequency(1000)) || ((control1 & BW_MASK) == encodeFilterBandwidth(800)));
+  }
+
+  // Register image for INT_CTRL_0_REG + index (index 0 to 3)
+  constexpr uint8_t getRegister(uint8_t index) const
+  {
+    return index == 0   ? control0
+           : index == 1 ? control1
+           : index == 2 ? control2
+                        : control3;
+  }
+};
+
+#endif
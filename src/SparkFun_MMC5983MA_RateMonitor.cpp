@@ -0,0 +1,244 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements the output data rate monitor.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_RateMonitor.h"
+
+// Integer square root, rounded down
+static uint32_t squareRoot64(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value)
+        bit >>= 2;
+
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+void SFE_MMC5983MA_RateMonitor::beginUpdate()
+{
+    version = version + 1;
+    __atomic_thread_fence(__ATOMIC_RELEASE); // The odd version must be visible before the results change
+}
+
+void SFE_MMC5983MA_RateMonitor::endUpdate()
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE); // Publish the results before the even version
+    version = version + 1;
+}
+
+void SFE_MMC5983MA_RateMonitor::raise(SF_MMC5983MA_ERROR errorCode)
+{
+    if (sensor != nullptr)
+    {
+        SAFE_CALLBACK(sensor->errorCallback, errorCode);
+    }
+}
+
+void SFE_MMC5983MA_RateMonitor::begin(SFE_MMC5983MA &mag)
+{
+    if (sensor != &mag)
+    {
+        if (sensor != nullptr)
+            sensor->removeFrameSink(this);
+        sensor = &mag;
+        mag.addFrameSink(this);
+    }
+
+    setExpectedRate(mag.getContinuousModeFrequency());
+}
+
+void SFE_MMC5983MA_RateMonitor::setExpectedRate(uint16_t frequency)
+{
+    report.configuredRate = (uint32_t)frequency * 1000;
+    reset();
+}
+
+void SFE_MMC5983MA_RateMonitor::setWindow(uint32_t windowLength)
+{
+    windowMicros = windowLength;
+}
+
+void SFE_MMC5983MA_RateMonitor::setThreshold(uint8_t percent)
+{
+    thresholdPercent = percent;
+}
+
+void SFE_MMC5983MA_RateMonitor::reset()
+{
+    uint32_t configuredRate = report.configuredRate;
+
+    beginUpdate();
+    report = SFE_MMC5983MA_RateReport();
+    report.configuredRate = configuredRate;
+    endUpdate();
+
+    started = false;
+    edgeMarked = false;
+    stalled = false;
+    stalls = 0;
+    checkedTicks = frameTicks;
+}
+
+void SFE_MMC5983MA_RateMonitor::markInterrupt(uint32_t now)
+{
+    edgeMicros = now;
+    edgeMarked = true;
+}
+
+void SFE_MMC5983MA_RateMonitor::onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp)
+{
+    (void)frame;
+
+    frameTicks = frameTicks + 1;
+
+    bool lowRate = false;
+
+    beginUpdate();
+
+    report.frames++;
+
+    if (edgeMarked)
+    {
+        uint32_t latency = timestamp - edgeMicros;
+        edgeMarked = false;
+
+        uint8_t bin = 0;
+        while ((bin < SFE_MMC5983MA_LATENCY_BINS - 1) && ((latency >> (bin + 1)) != 0))
+            bin++;
+        report.latencyHistogram[bin]++;
+
+        if (latency > report.maximumLatency)
+            report.maximumLatency = latency;
+    }
+
+    if (!started)
+    {
+        started = true;
+        windowStart = timestamp;
+    }
+    else
+    {
+        uint32_t interval = timestamp - previousFrame;
+
+        if ((intervals == 0) || (interval < windowMinimum))
+            windowMinimum = interval;
+        if ((intervals == 0) || (interval > windowMaximum))
+            windowMaximum = interval;
+        intervals++;
+        intervalSum += interval;
+        intervalSquares += (uint64_t)interval * interval;
+
+        uint32_t elapsed = timestamp - windowStart;
+        if (elapsed >= windowMicros)
+        {
+            report.measuredRate = (uint32_t)(((uint64_t)intervals * 1000000000ULL) / elapsed);
+            report.minimumInterval = windowMinimum;
+            report.maximumInterval = windowMaximum;
+
+            // Variance = mean of the squares - square of the mean, scaled by intervals^2
+            uint64_t scaledVariance = (intervalSquares * intervals) - ((uint64_t)intervalSum * intervalSum);
+            report.jitter = squareRoot64(scaledVariance) / intervals;
+
+            report.windows++;
+            if ((report.configuredRate != 0) &&
+                ((uint64_t)report.measuredRate * 100 < (uint64_t)report.configuredRate * thresholdPercent))
+            {
+                report.lowRateWindows++;
+                lowRate = true;
+            }
+
+            windowStart = timestamp;
+            intervals = 0;
+            intervalSum = 0;
+            intervalSquares = 0;
+        }
+    }
+    previousFrame = timestamp;
+
+    endUpdate();
+
+    if (lowRate)
+        raise(SF_MMC5983MA_ERROR::DATA_RATE_TOO_LOW);
+}
+
+bool SFE_MMC5983MA_RateMonitor::check(uint32_t now)
+{
+    uint8_t ticks = frameTicks;
+
+    if ((ticks != checkedTicks) || (report.configuredRate == 0))
+    {
+        checkedTicks = ticks;
+        lastProgress = now;
+        stalled = false;
+        return true;
+    }
+
+    if (!stalled && ((now - lastProgress) >= windowMicros))
+    {
+        stalled = true;
+        stalls++;
+        raise(SF_MMC5983MA_ERROR::DATA_STALLED);
+    }
+
+    return !stalled;
+}
+
+void SFE_MMC5983MA_RateMonitor::getReport(SFE_MMC5983MA_RateReport *snapshot) const
+{
+    sfe_mmc5983ma_seqlock_t startVersion;
+    do
+    {
+        startVersion = version;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE); // Read the version before the results
+
+        *snapshot = report;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE); // Read the results before checking the version again
+    } while ((startVersion & 1) || (version != startVersion));
+
+    snapshot->stalls = stalls;
+}
+
+uint32_t SFE_MMC5983MA_RateMonitor::getLatencyPercentile(const SFE_MMC5983MA_RateReport &snapshot, uint8_t percent)
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < SFE_MMC5983MA_LATENCY_BINS; i++)
+        total += snapshot.latencyHistogram[i];
+
+    if (total == 0)
+        return 0;
+
+    uint64_t target = ((uint64_t)total * percent + 99) / 100;
+    uint32_t count = 0;
+    for (uint8_t i = 0; i < SFE_MMC5983MA_LATENCY_BINS - 1; i++)
+    {
+        count += snapshot.latencyHistogram[i];
+        if (count >= target)
+            return (1UL << (i + 1)) - 1;
+    }
+
+    // Beyond the last bin's lower bound
+    return snapshot.maximumLatency;
+}
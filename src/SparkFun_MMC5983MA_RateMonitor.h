@@ -0,0 +1,132 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a monitor for the output data rate actually delivered in continuous mode.
+  getContinuousModeFrequency() only reports the configured rate. The delivered rate can be lower:
+  the filter bandwidth may be too narrow for the rate (1000Hz needs 800Hz), or bus stalls and long
+  interrupt latency can make frames late or lost.
+
+  The monitor is a frame sink. Over each window (one second by default) it measures the delivered
+  rate and the spread of the intervals between frames. It also builds a histogram of the latency
+  from the INT edge to the end of the read. When a window's rate falls below a threshold (a
+  percentage of the configured rate), it raises DATA_RATE_TOO_LOW through the driver's error
+  callback. When check() finds that no frames have arrived for a whole window, it raises
+  DATA_STALLED.
+
+  The results are published under a sequence lock (as in SFE_MMC5983MA_LatestFrame), so
+  getReport() takes a consistent snapshot while the ISR keeps running.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_RATE_MONITOR_
+#define _SPARKFUN_MMC5983MA_RATE_MONITOR_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+#include "SparkFun_MMC5983MA_LatestFrame.h"
+
+// Latency bin i counts latencies from 2^i to 2^(i+1) - 1 microseconds (bin 0 also counts 0).
+// The last bin counts everything from 2^(LATENCY_BINS - 1) up.
+static const uint8_t SFE_MMC5983MA_LATENCY_BINS = 16;
+
+struct SFE_MMC5983MA_RateReport
+{
+  // Rates in milliHertz. measuredRate covers the latest complete window.
+  uint32_t configuredRate = 0;
+  uint32_t measuredRate = 0;
+
+  // Intervals between frames over the latest complete window, in microseconds
+  uint32_t minimumInterval = 0;
+  uint32_t maximumInterval = 0;
+  uint32_t jitter = 0; // Standard deviation
+
+  uint32_t frames = 0;         // Frames seen in total
+  uint32_t windows = 0;        // Windows completed
+  uint32_t lowRateWindows = 0; // Windows below the threshold
+  uint32_t stalls = 0;         // Times check() found no frames for a whole window
+
+  // Latency from the INT edge (see markInterrupt()) to the end of the read, in microseconds
+  uint32_t maximumLatency = 0;
+  uint32_t latencyHistogram[SFE_MMC5983MA_LATENCY_BINS] = {};
+};
+
+class SFE_MMC5983MA_RateMonitor : public SFE_MMC5983MA_FrameSink
+{
+private:
+  SFE_MMC5983MA *sensor = nullptr;
+
+  uint32_t windowMicros = 1000000;
+  uint8_t thresholdPercent = 90;
+
+  // Results. Only written by onFrame(), inside the sequence lock.
+  volatile sfe_mmc5983ma_seqlock_t version = 0;
+  SFE_MMC5983MA_RateReport report;
+
+  // Current window. Only used by onFrame().
+  bool started = false;
+  uint32_t windowStart = 0;
+  uint32_t previousFrame = 0;
+  uint32_t intervals = 0;
+  uint32_t intervalSum = 0;
+  uint64_t intervalSquares = 0;
+  uint32_t windowMinimum = 0;
+  uint32_t windowMaximum = 0;
+
+  // Edge time from markInterrupt()
+  volatile uint32_t edgeMicros = 0;
+  volatile bool edgeMarked = false;
+
+  // Stall detection. frameTicks is a single byte so check() can read it atomically.
+  volatile uint8_t frameTicks = 0;
+  uint8_t checkedTicks = 0;
+  uint32_t lastProgress = 0;
+  bool stalled = false;
+  uint32_t stalls = 0; // Only written by check()
+
+  // Begins and ends an update of the results
+  void beginUpdate();
+  void endUpdate();
+
+  // Raises an error through the driver's error callback
+  void raise(SF_MMC5983MA_ERROR errorCode);
+
+public:
+  // Attaches the monitor to the sensor as a frame sink (once), and takes the configured rate from it.
+  // Call again after changing the continuous mode frequency.
+  void begin(SFE_MMC5983MA &mag);
+
+  // Sets the rate expected, in Hz, without a sensor. 0 disables the rate checks.
+  void setExpectedRate(uint16_t frequency);
+
+  // Sets the length of the measurement window. Longer windows average the rate over more frames.
+  void setWindow(uint32_t windowLength);
+
+  // Sets the threshold, as a percentage of the configured rate, below which a window raises DATA_RATE_TOO_LOW.
+  void setThreshold(uint8_t percent);
+
+  // Clears the results. Call while no frames are being read.
+  void reset();
+
+  // Call first thing in the INT pin ISR, with micros() (or the bus time base), to measure the read latency
+  void markInterrupt(uint32_t now);
+
+  // Driver hook: see SFE_MMC5983MA::addFrameSink(). Raises DATA_RATE_TOO_LOW in the reading context.
+  void onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp) override;
+
+  // Call regularly (e.g. from loop()) to detect a stalled stream, which onFrame() cannot.
+  // Raises DATA_STALLED once per stall. Returns false while stalled.
+  bool check(uint32_t now);
+
+  // Takes a consistent snapshot of the results. Do not call from an interrupt which can preempt onFrame().
+  void getReport(SFE_MMC5983MA_RateReport *snapshot) const;
+
+  // Returns the latency (upper bound of its histogram bin, in microseconds) which percent of reads beat
+  static uint32_t getLatencyPercentile(const SFE_MMC5983MA_RateReport &snapshot, uint8_t percent);
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a compile-time map of the write-only internal control registers and
+  their fields. Each field type carries its register, so the driver cannot set a bit in the
+  wrong register: the register is never passed separately. The bit masks are the ones
+  defined in SparkFun_MMC5983MA_Arduino_Library_Constants.h.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_REGISTERS_
+#define _SPARKFUN_MMC5983MA_REGISTERS_
+
+#include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
+
+// Number of internal control registers held in the shadow memory (INT_CTRL_0_REG to INT_CTRL_3_REG)
+static const uint8_t SFE_MMC5983MA_SHADOW_REGISTERS = 4;
+
+// A shadowed internal control register
+template <uint8_t Address>
+struct SFE_MMC5983MA_Register
+{
+  static_assert((Address >= INT_CTRL_0_REG) && (Address <= INT_CTRL_3_REG), "Only the internal control registers are shadowed");
+
+  static constexpr uint8_t address = Address;
+
+  // Index into the shadow memory
+  static constexpr uint8_t index = Address - INT_CTRL_0_REG;
+};
+
+// One or more adjacent bits of a shadowed register. Shift is the position of the lowest bit in Mask.
+template <typename Register, uint8_t Mask, uint8_t Shift = 0>
+struct SFE_MMC5983MA_Field
+{
+  static_assert(Mask != 0, "A field needs at least one bit");
+  static_assert(((Mask >> Shift) << Shift) == Mask, "Shift must not be above the lowest bit of Mask");
+
+  typedef Register RegisterType;
+  static constexpr uint8_t mask = Mask;
+  static constexpr uint8_t shift = Shift;
+};
+
+namespace SFE_MMC5983MA_Fields
+{
+  typedef SFE_MMC5983MA_Register<INT_CTRL_0_REG> InternalControl0;
+  typedef SFE_MMC5983MA_Register<INT_CTRL_1_REG> InternalControl1;
+  typedef SFE_MMC5983MA_Register<INT_CTRL_2_REG> InternalControl2;
+  typedef SFE_MMC5983MA_Register<INT_CTRL_3_REG> InternalControl3;
+
+  // Internal Control 0
+  typedef SFE_MMC5983MA_Field<InternalControl0, TM_M> TmM;
+  typedef SFE_MMC5983MA_Field<InternalControl0, TM_T> TmT;
+  typedef SFE_MMC5983MA_Field<InternalControl0, INT_MEAS_DONE_EN> IntMeasDoneEn;
+  typedef SFE_MMC5983MA_Field<InternalControl0, SET_OPERATION> Set;
+  typedef SFE_MMC5983MA_Field<InternalControl0, RESET_OPERATION> Reset;
+  typedef SFE_MMC5983MA_Field<InternalControl0, AUTO_SR_EN> AutoSrEn;
+  typedef SFE_MMC5983MA_Field<InternalControl0, OTP_READ> OtpRead;
+
+  // Internal Control 1
+  typedef SFE_MMC5983MA_Field<InternalControl1, BW1 | BW0> Bw;
+  typedef SFE_MMC5983MA_Field<InternalControl1, X_INHIBIT> XInhibit;
+  typedef SFE_MMC5983MA_Field<InternalControl1, YZ_INHIBIT> YzInhibit;
+  typedef SFE_MMC5983MA_Field<InternalControl1, SW_RST> SwRst;
+
+  // Internal Control 2
+  typedef SFE_MMC5983MA_Field<InternalControl2, CM_FREQ_2 | CM_FREQ_1 | CM_FREQ_0> CmFreq;
+  typedef SFE_MMC5983MA_Field<InternalControl2, CMM_EN> CmmEn;
+  typedef SFE_MMC5983MA_Field<InternalControl2, PRD_SET_2 | PRD_SET_1 | PRD_SET_0, 4> PrdSet;
+  typedef SFE_MMC5983MA_Field<InternalControl2, EN_PRD_SET> EnPrdSet;
+
+  // Internal Control 3
+  typedef SFE_MMC5983MA_Field<InternalControl3, ST_ENP> StEnp;
+  typedef SFE_MMC5983MA_Field<InternalControl3, ST_ENM> StEnm;
+  typedef SFE_MMC5983MA_Field<InternalControl3, SPI_3W> Spi3W;
+}
+
+#endif
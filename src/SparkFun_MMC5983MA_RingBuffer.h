@@ -0,0 +1,116 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a fixed-capacity, lock-free, single-producer / single-consumer ring buffer.
+  It has no Arduino dependencies so it can be exercised on a host, with threads standing in for the ISR.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_RING_BUFFER_
+#define _SPARKFUN_MMC5983MA_RING_BUFFER_
+
+#include <stdint.h>
+
+// On 8-bit AVR only single byte accesses are atomic, so the indexes must be single bytes there.
+#if defined(__AVR__)
+typedef uint8_t sfe_mmc5983ma_ring_index_t;
+#else
+typedef uint16_t sfe_mmc5983ma_ring_index_t;
+#endif
+
+// Capacity must be a power of two. The head and tail indexes are free-running and
+// wrap naturally, so Capacity must also be no more than half the index range.
+template <typename T, sfe_mmc5983ma_ring_index_t Capacity>
+class SFE_MMC5983MA_RingBuffer
+{
+  static_assert((Capacity >= 2) && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of two");
+  static_assert(Capacity <= (sfe_mmc5983ma_ring_index_t)(~(sfe_mmc5983ma_ring_index_t)0) / 2 + 1, "Capacity is too large");
+
+private:
+  T items[Capacity];
+
+  // head is only written by the producer, tail is only written by the consumer.
+  volatile sfe_mmc5983ma_ring_index_t head = 0;
+  volatile sfe_mmc5983ma_ring_index_t tail = 0;
+
+  // Statistics. Only written by the producer.
+  volatile uint32_t overruns = 0;
+  volatile sfe_mmc5983ma_ring_index_t highWaterMark = 0;
+
+public:
+  // Producer: adds an item. Returns false (and counts an overrun) if the buffer is full.
+  bool push(const T &item)
+  {
+    sfe_mmc5983ma_ring_index_t currentHead = head;
+    sfe_mmc5983ma_ring_index_t currentTail = tail;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // Don't overwrite an item before the consumer has copied it
+
+    sfe_mmc5983ma_ring_index_t used = currentHead - currentTail;
+    if (used >= Capacity)
+    {
+      overruns = overruns + 1;
+      return false;
+    }
+
+    items[currentHead & (Capacity - 1)] = item;
+    __atomic_thread_fence(__ATOMIC_RELEASE); // Publish the item before the new head
+    head = currentHead + 1;
+
+    if (used + 1 > highWaterMark)
+      highWaterMark = used + 1;
+
+    return true;
+  }
+
+  // Consumer: removes up to maxItems items into destination. Returns the number of items removed.
+  sfe_mmc5983ma_ring_index_t pop(T *destination, sfe_mmc5983ma_ring_index_t maxItems)
+  {
+    sfe_mmc5983ma_ring_index_t currentTail = tail;
+    sfe_mmc5983ma_ring_index_t currentHead = head;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // Don't read an item before the producer has published it
+
+    sfe_mmc5983ma_ring_index_t count = currentHead - currentTail;
+    if (count > maxItems)
+      count = maxItems;
+
+    for (sfe_mmc5983ma_ring_index_t i = 0; i < count; i++)
+      destination[i] = items[(currentTail + i) & (Capacity - 1)];
+
+    __atomic_thread_fence(__ATOMIC_RELEASE); // Finish copying before handing the slots back
+    tail = currentTail + count;
+
+    return count;
+  }
+
+  // Consumer: returns the number of items waiting.
+  sfe_mmc5983ma_ring_index_t available() const
+  {
+    return head - tail;
+  }
+
+  // Returns the number of items which could not be pushed because the buffer was full.
+  uint32_t getOverruns() const
+  {
+    return overruns;
+  }
+
+  // Returns the largest number of items which have been waiting at once.
+  sfe_mmc5983ma_ring_index_t getHighWaterMark() const
+  {
+    return highWaterMark;
+  }
+
+  // Returns the buffer capacity.
+  static constexpr sfe_mmc5983ma_ring_index_t capacity()
+  {
+    return Capacity;
+  }
+};
+
+#endif
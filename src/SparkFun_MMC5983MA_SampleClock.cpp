@@ -0,0 +1,157 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements the continuous mode sample clock.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_SampleClock.h"
+
+void SFE_MMC5983MA_SampleClock::setDownstream(SFE_MMC5983MA_FrameSink *downstreamSink)
+{
+    downstream = downstreamSink;
+}
+
+void SFE_MMC5983MA_SampleClock::setNominalRate(uint16_t frequency)
+{
+    nominalPeriod = (frequency == 0) ? 0 : (uint32_t)((1000000ULL << FRACTION_BITS) / frequency);
+    reset();
+}
+
+void SFE_MMC5983MA_SampleClock::reset()
+{
+    period = nominalPeriod;
+    locked = false;
+    edgeMarked = false;
+    sampleIndex = 0;
+    missedSamples = 0;
+    gaps = 0;
+    lastGap = 0;
+    lastError = 0;
+}
+
+void SFE_MMC5983MA_SampleClock::markInterrupt(uint32_t now)
+{
+    edgeMicros = now;
+    edgeMarked = true;
+}
+
+uint32_t SFE_MMC5983MA_SampleClock::update(uint32_t measuredMicros)
+{
+    if (nominalPeriod == 0)
+        return measuredMicros;
+
+    const uint64_t fractionMask = (1UL << FRACTION_BITS) - 1;
+
+    if (!locked)
+    {
+        // The first sample starts the grid
+        estimate = (uint64_t)measuredMicros << FRACTION_BITS;
+        locked = true;
+        return measuredMicros;
+    }
+
+    // Time since the latest sample. measuredMicros wraps (every 71 minutes); the difference does not.
+    int32_t delta = (int32_t)(measuredMicros - (uint32_t)(estimate >> FRACTION_BITS));
+    int64_t elapsed = ((int64_t)delta * (1L << FRACTION_BITS)) - (int64_t)(estimate & fractionMask);
+
+    // Whole periods since the latest sample: more than one means samples were lost
+    int64_t steps = (elapsed + (period / 2)) / period;
+    if (steps < 1)
+        steps = 1;
+
+    int64_t error = elapsed - (steps * (int64_t)period);
+
+    // More than half a period early (an edge which was not a sample, or the model has lost track),
+    // or too far ahead to count the samples between: start the grid again from here
+    if ((error < -(int64_t)(period / 2)) || (steps > 0xFFFF))
+    {
+        estimate = (uint64_t)measuredMicros << FRACTION_BITS;
+        period = nominalPeriod;
+        sampleIndex++;
+        lastGap = 0;
+        lastError = 0;
+        return measuredMicros;
+    }
+
+    // Phase: move a fraction of the way to the measured time. Period: a smaller fraction of the error per period.
+    estimate += (uint64_t)((steps * (int64_t)period) + (error / (1 << PHASE_SHIFT)));
+
+    int64_t newPeriod = (int64_t)period + ((error / steps) / (1 << PERIOD_SHIFT));
+    int64_t limit = nominalPeriod >> PERIOD_LIMIT_SHIFT;
+    if (newPeriod > (int64_t)nominalPeriod + limit)
+        newPeriod = (int64_t)nominalPeriod + limit;
+    if (newPeriod < (int64_t)nominalPeriod - limit)
+        newPeriod = (int64_t)nominalPeriod - limit;
+    period = (uint32_t)newPeriod;
+
+    sampleIndex += (uint32_t)steps;
+    lastGap = (uint16_t)(steps - 1);
+    if (lastGap > 0)
+    {
+        missedSamples += lastGap;
+        gaps++;
+    }
+    lastError = (int32_t)(error / (1 << FRACTION_BITS));
+
+    // Round to the nearest microsecond
+    return (uint32_t)((estimate + (1UL << (FRACTION_BITS - 1))) >> FRACTION_BITS);
+}
+
+void SFE_MMC5983MA_SampleClock::onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp)
+{
+    // Prefer the INT edge time to the read time
+    if (edgeMarked)
+    {
+        timestamp = edgeMicros;
+        edgeMarked = false;
+    }
+
+    timestamp = update(timestamp);
+
+    if (downstream != nullptr)
+        downstream->onFrame(frame, timestamp);
+}
+
+uint32_t SFE_MMC5983MA_SampleClock::getSampleIndex()
+{
+    return sampleIndex;
+}
+
+uint32_t SFE_MMC5983MA_SampleClock::getMissedSamples()
+{
+    return missedSamples;
+}
+
+uint32_t SFE_MMC5983MA_SampleClock::getGapCount()
+{
+    return gaps;
+}
+
+uint16_t SFE_MMC5983MA_SampleClock::getLastGap()
+{
+    return lastGap;
+}
+
+uint32_t SFE_MMC5983MA_SampleClock::getPeriod()
+{
+    return period;
+}
+
+uint32_t SFE_MMC5983MA_SampleClock::getMeasuredRate()
+{
+    if (period == 0)
+        return 0;
+    return (uint32_t)((1000000000ULL << FRACTION_BITS) / period);
+}
+
+int32_t SFE_MMC5983MA_SampleClock::getLastError()
+{
+    return lastError;
+}
@@ -0,0 +1,97 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a sample clock for continuous mode. The sensor's output data rate comes from
+  its own oscillator, so it drifts against the MCU clock by up to a few percent; and the time a
+  frame is read (or even the time the INT pin ISR runs) jitters with interrupt latency.
+
+  The clock models the sample times as t(k) = t0 + k * period, with period tracked against the MCU
+  clock. Each INT edge time is compared with the model's prediction: the error nudges the phase
+  (1/8 of it) and the period (1/256), so interrupt latency jitter is averaged out. Edges which come
+  a whole number of periods late mean samples were lost: they are counted, and the sample index
+  skips over them. Timestamps therefore stay on the sensor's sample grid.
+
+  It is a frame sink which passes each frame on to another sink (e.g. SFE_MMC5983MA_Broadcast)
+  with the modelled timestamp in place of the read time.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_SAMPLE_CLOCK_
+#define _SPARKFUN_MMC5983MA_SAMPLE_CLOCK_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+
+class SFE_MMC5983MA_SampleClock : public SFE_MMC5983MA_FrameSink
+{
+private:
+  SFE_MMC5983MA_FrameSink *downstream;
+
+  // Model. Times are in microseconds, Q8 (256 = 1us), unwrapped.
+  static const uint8_t FRACTION_BITS = 8;
+  uint32_t nominalPeriod = 0; // 0 until setNominalRate()
+  uint32_t period = 0;
+  uint64_t estimate = 0;      // Time of the latest sample
+  bool locked = false;
+
+  // Edge time from markInterrupt(), used in place of the read time
+  volatile uint32_t edgeMicros = 0;
+  volatile bool edgeMarked = false;
+
+  uint32_t sampleIndex = 0;
+  uint32_t missedSamples = 0;
+  uint32_t gaps = 0;
+  uint16_t lastGap = 0;
+  int32_t lastError = 0; // Microseconds
+
+  static const uint8_t PHASE_SHIFT = 3;
+  static const uint8_t PERIOD_SHIFT = 8;
+
+  // The tracked period may not stray more than 1/8 from nominal
+  static const uint8_t PERIOD_LIMIT_SHIFT = 3;
+
+public:
+  SFE_MMC5983MA_SampleClock(SFE_MMC5983MA_FrameSink *downstreamSink = nullptr) : downstream(downstreamSink) {}
+
+  // Sets the sink which is given each frame with its modelled timestamp
+  void setDownstream(SFE_MMC5983MA_FrameSink *downstreamSink);
+
+  // Sets the configured output data rate (see getContinuousModeFrequency()) and restarts the model
+  void setNominalRate(uint16_t frequency);
+
+  // Restarts the model: the next sample starts the grid again
+  void reset();
+
+  // Call first thing in the INT pin ISR, with micros() (or the bus time base), to timestamp the edge
+  // rather than the read
+  void markInterrupt(uint32_t now);
+
+  // Adds a sample time, returning its modelled timestamp. Called by onFrame().
+  // Before setNominalRate() there is no model, and the time is returned unchanged.
+  uint32_t update(uint32_t measuredMicros);
+
+  // Driver hook: see SFE_MMC5983MA::addFrameSink()
+  void onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp) override;
+
+  // Index of the latest sample on the grid, counting lost samples. The first sample is 0.
+  uint32_t getSampleIndex();
+
+  // Samples lost in total, the number of gaps they were lost in, and those lost just before the latest sample
+  uint32_t getMissedSamples();
+  uint32_t getGapCount();
+  uint16_t getLastGap();
+
+  // The tracked sample period, in microseconds Q8 (256 = 1us), and as a rate in milliHertz
+  uint32_t getPeriod();
+  uint32_t getMeasuredRate();
+
+  // Difference between the latest edge time and the model's prediction, in microseconds
+  int32_t getLastError();
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares an interrupt-fed sampler for continuous mode. Frames are pushed into a
+  lock-free single-producer / single-consumer ring by the INT pin ISR (or a deferred handler)
+  and drained in batches by the consumer, with overrun counters and a high-water mark.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_SAMPLER_
+#define _SPARKFUN_MMC5983MA_SAMPLER_
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+#include "SparkFun_MMC5983MA_RingBuffer.h"
+
+template <sfe_mmc5983ma_ring_index_t Capacity>
+class SFE_MMC5983MA_Sampler
+{
+private:
+  SFE_MMC5983MA *_mag;
+  SFE_MMC5983MA_RingBuffer<SFE_MMC5983MA_Frame, Capacity> ring;
+
+  // interruptCount is only written by onInterrupt(), servicedCount only by service().
+  volatile uint8_t interruptCount = 0;
+  uint8_t servicedCount = 0;
+
+  // Producer statistics.
+  volatile uint32_t missedInterrupts = 0;
+  volatile uint32_t readFailures = 0;
+
+public:
+  SFE_MMC5983MA_Sampler(SFE_MMC5983MA &mag) : _mag(&mag) {}
+
+  // Producer: reads a frame (clearing the done bits) and pushes it into the ring.
+  // Call this directly from the INT pin ISR if the bus can be used from an interrupt (e.g. SPI),
+  // otherwise call onInterrupt() from the ISR and service() from a deferred handler.
+  bool sample()
+  {
+    SFE_MMC5983MA_Frame frame;
+    if (!_mag->readFrame(&frame))
+    {
+      readFailures = readFailures + 1;
+      return false;
+    }
+    return ring.push(frame);
+  }
+
+  // Call from the INT pin ISR when sampling from a deferred handler. Does not touch the bus.
+  void onInterrupt()
+  {
+    interruptCount = interruptCount + 1;
+  }
+
+  // Producer, deferred: samples once if onInterrupt() has been called since the last service().
+  // Interrupts which arrive faster than service() is called are counted as missed.
+  // Returns true if a frame was pushed.
+  bool service()
+  {
+    uint8_t pending = interruptCount - servicedCount;
+    if (pending == 0)
+      return false;
+
+    servicedCount += pending;
+    if (pending > 1)
+      missedInterrupts = missedInterrupts + (pending - 1);
+
+    return sample();
+  }
+
+  // Consumer: copies up to maxFrames frames into frames. Returns the number of frames copied.
+  sfe_mmc5983ma_ring_index_t drain(SFE_MMC5983MA_Frame *frames, sfe_mmc5983ma_ring_index_t maxFrames)
+  {
+    return ring.pop(frames, maxFrames);
+  }
+
+  // Consumer: returns the number of frames waiting.
+  sfe_mmc5983ma_ring_index_t available() const
+  {
+    return ring.available();
+  }
+
+  // Returns the number of frames dropped because the ring was full.
+  uint32_t getOverruns() const
+  {
+    return ring.getOverruns();
+  }
+
+  // Returns the number of interrupts which were not serviced before the next one arrived.
+  uint32_t getMissedInterrupts() const
+  {
+    return missedInterrupts;
+  }
+
+  // Returns the number of frames which could not be read from the sensor.
+  uint32_t getReadFailures() const
+  {
+    return readFailures;
+  }
+
+  // Returns the largest number of frames which have been waiting at once.
+  sfe_mmc5983ma_ring_index_t getHighWaterMark() const
+  {
+    return ring.getHighWaterMark();
+  }
+};
+
+#endif
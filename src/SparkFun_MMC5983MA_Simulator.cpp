@@ -0,0 +1,445 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file implements a register-level model of the MMC5983MA which plugs in as a bus backend.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Simulator.h"
+
+// The reset time is 10 msec.
+static const uint32_t RESET_TIME_MICROS = 10000;
+
+SFE_MMC5983MA_Simulator::SFE_MMC5983MA_Simulator()
+{
+    powerOnReset();
+}
+
+void SFE_MMC5983MA_Simulator::powerOnReset()
+{
+    for (uint8_t i = 0; i < sizeof(outputRegisters); i++)
+        outputRegisters[i] = 0;
+    for (uint8_t i = 0; i < sizeof(controlRegisters); i++)
+        controlRegisters[i] = 0;
+
+    // The OTP has been read at power on
+    outputRegisters[STATUS_REG] = OTP_READ_DONE;
+
+    magneticDoneTime = 0;
+    temperatureDoneTime = 0;
+    resetDoneTime = 0;
+    nextContinuousTime = 0;
+    continuousSampleCount = 0;
+    setPolarity = true;
+    interruptAsserted = false;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::measurementTime()
+{
+    switch (controlRegisters[INT_CTRL_1_REG - INT_CTRL_0_REG] & (BW1 | BW0))
+    {
+    case BW1 | BW0:
+        return 500;
+
+    case BW1:
+        return 2000;
+
+    case BW0:
+        return 4000;
+
+    default:
+        return 8000;
+    }
+}
+
+uint32_t SFE_MMC5983MA_Simulator::continuousPeriod()
+{
+    uint8_t control2 = controlRegisters[INT_CTRL_2_REG - INT_CTRL_0_REG];
+    if ((control2 & CMM_EN) == 0)
+        return 0;
+
+    switch (control2 & 0x07)
+    {
+    case 0x01:
+        return 1000000; // 1Hz
+
+    case 0x02:
+        return 100000; // 10Hz
+
+    case 0x03:
+        return 50000; // 20Hz
+
+    case 0x04:
+        return 20000; // 50Hz
+
+    case 0x05:
+        return 10000; // 100Hz
+
+    case 0x06:
+        return 5000; // 200Hz
+
+    case 0x07:
+        return 1000; // 1000Hz
+
+    default:
+        return 0; // Off
+    }
+}
+
+uint16_t SFE_MMC5983MA_Simulator::periodicSetSamples()
+{
+    static const uint16_t samples[8] = {1, 25, 75, 100, 250, 500, 1000, 2000};
+    return samples[(controlRegisters[INT_CTRL_2_REG - INT_CTRL_0_REG] >> 4) & 0x07];
+}
+
+int32_t SFE_MMC5983MA_Simulator::nextNoise()
+{
+    if (noiseAmplitude == 0)
+        return 0;
+
+    // Deterministic linear congruential generator so simulations are repeatable
+    noiseState = (noiseState * 1664525UL) + 1013904223UL;
+    uint32_t range = (2UL * noiseAmplitude) + 1;
+    return (int32_t)((noiseState >> 8) % range) - (int32_t)noiseAmplitude;
+}
+
+void SFE_MMC5983MA_Simulator::measurementDone(uint8_t doneMask)
+{
+    outputRegisters[STATUS_REG] |= doneMask;
+
+    if ((controlRegisters[0] & INT_MEAS_DONE_EN) && !interruptAsserted)
+    {
+        interruptAsserted = true;
+        interruptCount++;
+    }
+}
+
+void SFE_MMC5983MA_Simulator::completeMagneticMeasurement()
+{
+    uint8_t control1 = controlRegisters[INT_CTRL_1_REG - INT_CTRL_0_REG];
+    uint32_t values[3];
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        // SET and RESET flip the sign of the field but not of the bridge offset
+        int32_t value = 131072 + (setPolarity ? field[axis] : -field[axis]) + bridgeOffset[axis] + nextNoise();
+        if (value < 0)
+            value = 0;
+        if (value > 262143)
+            value = 262143;
+        values[axis] = (uint32_t)value;
+    }
+
+    // Inhibited channels keep their previous output
+    if ((control1 & X_INHIBIT) == 0)
+    {
+        outputRegisters[X_OUT_0_REG] = values[0] >> 10;
+        outputRegisters[X_OUT_1_REG] = (values[0] >> 2) & 0xFF;
+        outputRegisters[XYZ_OUT_2_REG] = (outputRegisters[XYZ_OUT_2_REG] & ~X2_MASK) | ((values[0] & 0x03) << 6);
+    }
+    if ((control1 & YZ_INHIBIT) == 0)
+    {
+        outputRegisters[Y_OUT_0_REG] = values[1] >> 10;
+        outputRegisters[Y_OUT_1_REG] = (values[1] >> 2) & 0xFF;
+        outputRegisters[Z_OUT_0_REG] = values[2] >> 10;
+        outputRegisters[Z_OUT_1_REG] = (values[2] >> 2) & 0xFF;
+        outputRegisters[XYZ_OUT_2_REG] = (outputRegisters[XYZ_OUT_2_REG] & ~(Y2_MASK | Z2_MASK)) | ((values[1] & 0x03) << 4) | ((values[2] & 0x03) << 2);
+    }
+
+    magneticMeasurementCount++;
+    measurementDone(MEAS_M_DONE);
+}
+
+void SFE_MMC5983MA_Simulator::advanceTo(uint64_t time)
+{
+    while (true)
+    {
+        // Find the earliest pending event
+        uint64_t next = 0;
+        if ((magneticDoneTime != 0) && ((next == 0) || (magneticDoneTime < next)))
+            next = magneticDoneTime;
+        if ((temperatureDoneTime != 0) && ((next == 0) || (temperatureDoneTime < next)))
+            next = temperatureDoneTime;
+        if ((resetDoneTime != 0) && ((next == 0) || (resetDoneTime < next)))
+            next = resetDoneTime;
+        if ((nextContinuousTime != 0) && ((next == 0) || (nextContinuousTime < next)))
+            next = nextContinuousTime;
+
+        if ((next == 0) || (next > time))
+            break;
+
+        now = next;
+
+        if (resetDoneTime == next)
+        {
+            resetDoneTime = 0;
+            outputRegisters[STATUS_REG] |= OTP_READ_DONE;
+        }
+        if (magneticDoneTime == next)
+        {
+            magneticDoneTime = 0;
+            completeMagneticMeasurement();
+        }
+        if (temperatureDoneTime == next)
+        {
+            temperatureDoneTime = 0;
+            outputRegisters[T_OUT_REG] = temperature;
+            temperatureMeasurementCount++;
+            measurementDone(MEAS_T_DONE);
+        }
+        if (nextContinuousTime == next)
+        {
+            uint32_t period = continuousPeriod();
+            nextContinuousTime = (period > 0) ? next + period : 0;
+
+            // Periodic SET happens before the measurement, every PRD_SET samples
+            uint8_t control2 = controlRegisters[INT_CTRL_2_REG - INT_CTRL_0_REG];
+            if ((controlRegisters[0] & AUTO_SR_EN) && (control2 & EN_PRD_SET))
+            {
+                if (continuousSampleCount == 0)
+                {
+                    setPolarity = true;
+                    setCount++;
+                }
+                continuousSampleCount++;
+                if (continuousSampleCount >= periodicSetSamples())
+                    continuousSampleCount = 0;
+            }
+
+            completeMagneticMeasurement();
+        }
+    }
+
+    now = time;
+}
+
+void SFE_MMC5983MA_Simulator::busTransaction(uint8_t length)
+{
+    // Register address plus data
+    uint32_t nanos = busNanosRemainder + (byteNanos * (uint32_t)(length + 1));
+    busNanosRemainder = nanos % 1000;
+    advanceTo(now + transactionMicros + (nanos / 1000));
+    transactionCount++;
+}
+
+void SFE_MMC5983MA_Simulator::writeRegister(uint8_t registerAddress, uint8_t value)
+{
+    switch (registerAddress)
+    {
+    case STATUS_REG:
+    {
+        // Writing 1 clears the done bits. The other bits are read-only.
+        outputRegisters[STATUS_REG] &= ~(value & (MEAS_M_DONE | MEAS_T_DONE));
+        if ((outputRegisters[STATUS_REG] & (MEAS_M_DONE | MEAS_T_DONE)) == 0)
+            interruptAsserted = false;
+    }
+    break;
+
+    case INT_CTRL_0_REG:
+    {
+        // Only one conversion may run at a time
+        if ((value & TM_M) && ((value & TM_T) || (temperatureDoneTime != 0)))
+            protocolErrorCount++;
+        else if ((value & TM_T) && (magneticDoneTime != 0))
+            protocolErrorCount++;
+
+        if (value & TM_M)
+        {
+            // A new measurement clears the previous done flag
+            outputRegisters[STATUS_REG] &= ~MEAS_M_DONE;
+            magneticDoneTime = now + measurementTime();
+        }
+        if (value & TM_T)
+        {
+            outputRegisters[STATUS_REG] &= ~MEAS_T_DONE;
+            temperatureDoneTime = now + measurementTime();
+        }
+        if (value & SET_OPERATION)
+        {
+            setPolarity = true;
+            setCount++;
+        }
+        if (value & RESET_OPERATION)
+        {
+            setPolarity = false;
+            resetCount++;
+        }
+        if (value & OTP_READ)
+            outputRegisters[STATUS_REG] |= OTP_READ_DONE;
+
+        // Only the enable bits are retained
+        controlRegisters[0] = value & (INT_MEAS_DONE_EN | AUTO_SR_EN);
+    }
+    break;
+
+    case INT_CTRL_1_REG:
+    {
+        if (value & SW_RST)
+        {
+            powerOnReset();
+            outputRegisters[STATUS_REG] &= ~OTP_READ_DONE;
+            resetDoneTime = now + RESET_TIME_MICROS;
+            return;
+        }
+        controlRegisters[1] = value;
+    }
+    break;
+
+    case INT_CTRL_2_REG:
+    {
+        uint32_t oldPeriod = continuousPeriod();
+        controlRegisters[2] = value;
+        uint32_t newPeriod = continuousPeriod();
+        if (newPeriod != oldPeriod)
+        {
+            // Continuous mode (re)starts from now
+            nextContinuousTime = (newPeriod > 0) ? now + newPeriod : 0;
+            continuousSampleCount = 0;
+        }
+    }
+    break;
+
+    case INT_CTRL_3_REG:
+    {
+        controlRegisters[3] = value;
+    }
+    break;
+
+    default:
+        break;
+    }
+}
+
+bool SFE_MMC5983MA_Simulator::readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+{
+    busTransaction(packetLength);
+
+    // The register address auto-increments
+    for (uint8_t i = 0; i < packetLength; i++)
+    {
+        uint8_t address = registerAddress + i;
+        if (address <= STATUS_REG)
+            buffer[i] = outputRegisters[address];
+        else if (address == PROD_ID_REG)
+            buffer[i] = PROD_ID;
+        else
+            buffer[i] = 0; // The control registers are write-only
+    }
+    return true;
+}
+
+bool SFE_MMC5983MA_Simulator::writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+{
+    busTransaction(packetLength);
+
+    for (uint8_t i = 0; i < packetLength; i++)
+        writeRegister(registerAddress + i, buffer[i]);
+    return true;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::getMicros()
+{
+    return (uint32_t)now;
+}
+
+void SFE_MMC5983MA_Simulator::waitMicros(uint32_t duration)
+{
+    advanceTo(now + duration);
+}
+
+void SFE_MMC5983MA_Simulator::setField(int32_t x, int32_t y, int32_t z)
+{
+    field[0] = x;
+    field[1] = y;
+    field[2] = z;
+}
+
+void SFE_MMC5983MA_Simulator::setBridgeOffset(int32_t x, int32_t y, int32_t z)
+{
+    bridgeOffset[0] = x;
+    bridgeOffset[1] = y;
+    bridgeOffset[2] = z;
+}
+
+void SFE_MMC5983MA_Simulator::setTemperature(uint8_t rawTemperature)
+{
+    temperature = rawTemperature;
+}
+
+void SFE_MMC5983MA_Simulator::setNoise(uint16_t amplitude)
+{
+    noiseAmplitude = amplitude;
+}
+
+void SFE_MMC5983MA_Simulator::setBusTiming(uint32_t overheadMicros, uint32_t perByteNanos)
+{
+    transactionMicros = overheadMicros;
+    byteNanos = perByteNanos;
+}
+
+uint64_t SFE_MMC5983MA_Simulator::getTime()
+{
+    return now;
+}
+
+bool SFE_MMC5983MA_Simulator::isInterruptAsserted()
+{
+    return interruptAsserted;
+}
+
+uint8_t SFE_MMC5983MA_Simulator::peekRegister(uint8_t registerAddress)
+{
+    if (registerAddress <= STATUS_REG)
+        return outputRegisters[registerAddress];
+    if ((registerAddress >= INT_CTRL_0_REG) && (registerAddress <= INT_CTRL_3_REG))
+        return controlRegisters[registerAddress - INT_CTRL_0_REG];
+    if (registerAddress == PROD_ID_REG)
+        return PROD_ID;
+    return 0;
+}
+
+bool SFE_MMC5983MA_Simulator::isSetPolarity()
+{
+    return setPolarity;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::getTransactionCount()
+{
+    return transactionCount;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::getMagneticMeasurementCount()
+{
+    return magneticMeasurementCount;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::getTemperatureMeasurementCount()
+{
+    return temperatureMeasurementCount;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::getInterruptCount()
+{
+    return interruptCount;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::getSetCount()
+{
+    return setCount;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::getResetCount()
+{
+    return resetCount;
+}
+
+uint32_t SFE_MMC5983MA_Simulator::getProtocolErrorCount()
+{
+    return protocolErrorCount;
+}
@@ -0,0 +1,156 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares a register-level model of the MMC5983MA which plugs in as a bus backend.
+  It runs on simulated time, so the driver's timing and throughput can be measured
+  deterministically on a host with no hardware attached.
+
+  The model covers:
+    registers 0x00 to 0x0C and 0x2F, with 0x09 to 0x0C write-only
+    MEAS_M_DONE / MEAS_T_DONE timing for each BW1/0 setting
+    continuous mode at the CM_FREQ output data rate, with periodic SET
+    SET / RESET polarity and bridge offset
+    software reset and OTP_READ_DONE
+    the INT output
+    protocol errors: writes which start a magnetic and a temperature conversion at the same time
+  Bus transactions take a configurable amount of simulated time.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_SIMULATOR_
+#define _SPARKFUN_MMC5983MA_SIMULATOR_
+
+#include "SparkFun_MMC5983MA_Bus.h"
+
+class SFE_MMC5983MA_Simulator : public SFE_MMC5983MA_Bus
+{
+private:
+  // Readable registers 0x00 to 0x08
+  uint8_t outputRegisters[9];
+
+  // Write-only registers 0x09 to 0x0C, as last written (command bits are not retained)
+  uint8_t controlRegisters[4];
+
+  // Simulated time in microseconds
+  uint64_t now = 0;
+
+  // Pending events. 0 means none pending.
+  uint64_t magneticDoneTime = 0;
+  uint64_t temperatureDoneTime = 0;
+  uint64_t resetDoneTime = 0;
+  uint64_t nextContinuousTime = 0;
+
+  // Bus timing
+  uint32_t transactionMicros = 25;
+  uint32_t byteNanos = 22500;
+  uint32_t busNanosRemainder = 0;
+
+  // Sensor state
+  int32_t field[3] = {0, 0, 0};
+  int32_t bridgeOffset[3] = {0, 0, 0};
+  uint8_t temperature = 0x80;
+  bool setPolarity = true;
+  uint16_t noiseAmplitude = 0;
+  uint32_t noiseState = 1;
+  uint16_t continuousSampleCount = 0;
+
+  // INT output
+  bool interruptAsserted = false;
+
+  // Statistics
+  uint32_t transactionCount = 0;
+  uint32_t magneticMeasurementCount = 0;
+  uint32_t temperatureMeasurementCount = 0;
+  uint32_t interruptCount = 0;
+  uint32_t setCount = 0;
+  uint32_t resetCount = 0;
+  uint32_t protocolErrorCount = 0;
+
+  // Advances simulated time, processing any events which fall due
+  void advanceTo(uint64_t time);
+
+  // Advances simulated time by the duration of a bus transaction of the given length
+  void busTransaction(uint8_t length);
+
+  // Handles a write to a register
+  void writeRegister(uint8_t registerAddress, uint8_t value);
+
+  // Latches a new magnetic measurement into the output registers
+  void completeMagneticMeasurement();
+
+  // Sets status bits and raises INT if enabled
+  void measurementDone(uint8_t doneMask);
+
+  // Measurement time in microseconds from BW1/0
+  uint32_t measurementTime();
+
+  // Continuous mode period in microseconds from CM_FREQ. 0 if continuous mode is off.
+  uint32_t continuousPeriod();
+
+  // Samples between periodic SET operations from PRD_SET
+  uint16_t periodicSetSamples();
+
+  // Returns the next pseudo-random noise value in [-noiseAmplitude, noiseAmplitude]
+  int32_t nextNoise();
+
+public:
+  SFE_MMC5983MA_Simulator();
+
+  // Bus backend
+  bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) override;
+  bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) override;
+  uint32_t getMicros() override;
+  void waitMicros(uint32_t duration) override;
+
+  // Returns the device to its power-on state. Simulated time keeps running.
+  void powerOnReset();
+
+  // Sets the external field, in counts relative to mid-scale (131072). 16384 counts per Gauss.
+  void setField(int32_t x, int32_t y, int32_t z);
+
+  // Sets the bridge offset, in counts. This is removed by combining SET and RESET measurements.
+  void setBridgeOffset(int32_t x, int32_t y, int32_t z);
+
+  // Sets the raw T_OUT value reported by temperature measurements
+  void setTemperature(uint8_t rawTemperature);
+
+  // Adds uniform pseudo-random noise of +/- amplitude counts to each measurement
+  void setNoise(uint16_t amplitude);
+
+  // Sets the simulated duration of a bus transaction: a fixed overhead plus a time per byte.
+  // Defaults to approximately 400kHz I2C: 25us + 22.5us per byte.
+  void setBusTiming(uint32_t overheadMicros, uint32_t perByteNanos);
+
+  // Returns the simulated time in microseconds
+  uint64_t getTime();
+
+  // Returns true while the INT output is asserted. It is cleared by clearing the done bits.
+  bool isInterruptAsserted();
+
+  // Returns the value of a register, including the write-only control registers
+  uint8_t peekRegister(uint8_t registerAddress);
+
+  // Returns true if the sensor is currently in the SET state, false if RESET
+  bool isSetPolarity();
+
+  // Statistics
+  uint32_t getTransactionCount();
+  uint32_t getMagneticMeasurementCount();
+  uint32_t getTemperatureMeasurementCount();
+  uint32_t getInterruptCount();
+  uint32_t getSetCount();
+  uint32_t getResetCount();
+
+  // Writes which break the datasheet rule that TM_M and TM_T cannot be high at the same time:
+  // both set in one write, or either set while the other conversion is still running.
+  // The conversions still run, so the rest of the model carries on.
+  uint32_t getProtocolErrorCount();
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares the optional bus transaction and API call instrumentation.
+  The statistics live in storage handed to the driver with setStats(), not in the driver itself,
+  so the driver classes are the same size with or without them. The code which records them is
+  compiled out completely unless SFE_MMC5983MA_ENABLE_STATS is defined.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_STATS_
+#define _SPARKFUN_MMC5983MA_STATS_
+
+#include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
+
+// Define this in your build flags (or uncomment it here) to count bus transactions and time each API call.
+// The library is compiled separately from the sketch: a #define in the sketch has no effect on it.
+// #define SFE_MMC5983MA_ENABLE_STATS
+
+// The API calls which are timed
+enum class SFE_MMC5983MA_API : uint8_t
+{
+  GET_MEASUREMENT_XYZ,
+  GET_MEASUREMENT_AXIS, // getMeasurementX/Y/Z
+  START_MEASUREMENT,
+  IS_MEASUREMENT_READY,
+  WAIT_UNTIL_MEASUREMENT_READY,
+  READ_FIELDS_XYZ,
+  READ_FRAME,
+  CLEAR_MEAS_DONE_INTERRUPT,
+  GET_TEMPERATURE,
+  START_TEMPERATURE_MEASUREMENT,
+  READ_TEMPERATURE,
+  SOFT_RESET,
+  SET_RESET_OPERATION, // performSetOperation / performResetOperation
+  APPLY_PROFILE,
+  SHADOW_REGISTER_WRITE, // Every control register write made through the shadow memory
+  COUNT
+};
+
+// Bus totals, across all calls
+struct SFE_MMC5983MA_BusStats
+{
+  uint32_t transactions = 0;
+  uint32_t bytesRead = 0;
+  uint32_t bytesWritten = 0;
+  uint32_t failures = 0; // Transactions which returned false
+  uint32_t timeouts = 0; // Measurements which did not complete before the timeout
+};
+
+// Per API call statistics. histogram[i] counts calls which took 2^i to 2^(i+1)-1 microseconds
+// (histogram[0] also counts calls which took 0us, histogram[15] everything from 32.768ms up).
+// The bins saturate at 65535.
+struct SFE_MMC5983MA_CallStats
+{
+  static const uint8_t HISTOGRAM_BINS = 16;
+
+  uint32_t calls = 0;
+  uint32_t totalMicros = 0;
+  uint32_t maxMicros = 0;
+  uint16_t histogram[HISTOGRAM_BINS] = {0};
+
+  void record(uint32_t duration)
+  {
+    calls++;
+    totalMicros += duration;
+    if (duration > maxMicros)
+      maxMicros = duration;
+
+    uint8_t bin = 0;
+    while ((duration > 1) && (bin < (HISTOGRAM_BINS - 1)))
+    {
+      duration >>= 1;
+      bin++;
+    }
+    if (histogram[bin] < 0xFFFF)
+      histogram[bin]++;
+  }
+};
+
+// A complete snapshot, e.g. for telemetry
+struct SFE_MMC5983MA_Stats
+{
+  SFE_MMC5983MA_BusStats bus;
+  SFE_MMC5983MA_CallStats calls[(uint8_t)SFE_MMC5983MA_API::COUNT];
+};
+
+#endif
@@ -0,0 +1,255 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares the I2C and SPI transport policies used by the MMC5983MA IO layer,
+  and the build flags which select the buses whose code is compiled in.
+  Each policy only knows about its own bus. The functions are defined inline so the hot
+  register reads inline into the IO layer.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_TRANSPORT_
+#define _SPARKFUN_MMC5983MA_TRANSPORT_
+
+#include "SparkFun_MMC5983MA_Arduino_Library_Constants.h"
+#include "SparkFun_MMC5983MA_Bus.h"
+
+// Wherever Wire and SPI exist, both transports are declared and the IO layer always holds both,
+// so the class layout is the same whatever the flags below.
+#ifdef ARDUINO
+#include <Wire.h>
+#include <SPI.h>
+#endif
+
+// Define one of these in your build flags (e.g. build_flags in platformio.ini, or uncomment it here)
+// to compile out the code for the buses you are not using. Only the remaining bus is linked and the
+// IO layer no longer branches on the bus type at run time.
+// SFE_MMC5983MA_BUS_ONLY keeps only custom SFE_MMC5983MA_Bus backends (simulators, Linux userspace, etc.)
+// The library is compiled separately from the sketch: a #define in the sketch has no effect on it.
+// #define SFE_MMC5983MA_SPI_ONLY
+// #define SFE_MMC5983MA_I2C_ONLY
+// #define SFE_MMC5983MA_BUS_ONLY
+
+// Without Arduino there is no Wire or SPI: only custom bus backends are available
+#if !defined(ARDUINO) && !defined(SFE_MMC5983MA_BUS_ONLY)
+#define SFE_MMC5983MA_BUS_ONLY
+#endif
+
+#if (defined(SFE_MMC5983MA_SPI_ONLY) + defined(SFE_MMC5983MA_I2C_ONLY) + defined(SFE_MMC5983MA_BUS_ONLY)) > 1
+#error "Define only one of SFE_MMC5983MA_SPI_ONLY, SFE_MMC5983MA_I2C_ONLY and SFE_MMC5983MA_BUS_ONLY"
+#endif
+
+#if !defined(SFE_MMC5983MA_SPI_ONLY) && !defined(SFE_MMC5983MA_BUS_ONLY)
+#define SFE_MMC5983MA_USE_I2C
+#endif
+
+#if !defined(SFE_MMC5983MA_I2C_ONLY) && !defined(SFE_MMC5983MA_BUS_ONLY)
+#define SFE_MMC5983MA_USE_SPI
+#endif
+
+#if !defined(SFE_MMC5983MA_SPI_ONLY) && !defined(SFE_MMC5983MA_I2C_ONLY)
+#define SFE_MMC5983MA_USE_BUS
+#endif
+
+#ifdef ARDUINO
+class SFE_MMC5983MA_I2C_Transport
+{
+private:
+  TwoWire *_i2cPort = nullptr;
+
+  // Read mode. See setRepeatedStart().
+  bool repeatedStart = false;
+
+  // Sets the register address for the read which follows
+  bool selectRegister(const uint8_t registerAddress)
+  {
+    _i2cPort->beginTransmission(I2C_ADDR);
+    _i2cPort->write(registerAddress);
+    // With repeatedStart, no STOP is sent and the read follows with a repeated START
+    return _i2cPort->endTransmission(!repeatedStart) == 0;
+  }
+
+public:
+  void begin(TwoWire &i2cPort)
+  {
+    _i2cPort = &i2cPort;
+  }
+
+  // Use a repeated START between the register address write and the data read,
+  // instead of a STOP and a new START. This saves a STOP/START and a bus arbitration on every read.
+  void setRepeatedStart(bool enable)
+  {
+    repeatedStart = enable;
+  }
+
+  bool isConnected()
+  {
+    // No separate address probe: the register address write is NACKed if the device is absent
+    uint8_t id = 0;
+    return readSingleByte(PROD_ID_REG, &id) && (id == PROD_ID);
+  }
+
+  bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+  {
+    _i2cPort->beginTransmission(I2C_ADDR);
+    _i2cPort->write(registerAddress);
+    for (uint8_t i = 0; i < packetLength; i++)
+      _i2cPort->write(buffer[i]);
+    return _i2cPort->endTransmission() == 0;
+  }
+
+  bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+  {
+    bool success = selectRegister(registerAddress);
+
+    uint8_t returned = _i2cPort->requestFrom(I2C_ADDR, packetLength);
+    for (uint8_t i = 0; (i < packetLength) && (i < returned); i++)
+      buffer[i] = _i2cPort->read();
+    success &= returned == packetLength;
+    return success;
+  }
+
+  bool readSingleByte(const uint8_t registerAddress, uint8_t *buffer)
+  {
+    bool success = selectRegister(registerAddress);
+
+    uint8_t returned = _i2cPort->requestFrom(I2C_ADDR, 1U);
+    if (returned == 1)
+      *buffer = _i2cPort->read();
+    success &= returned == 1;
+    return success;
+  }
+
+  bool writeSingleByte(const uint8_t registerAddress, const uint8_t value)
+  {
+    _i2cPort->beginTransmission(I2C_ADDR);
+    _i2cPort->write(registerAddress);
+    _i2cPort->write(value);
+    return _i2cPort->endTransmission() == 0;
+  }
+};
+#endif
+
+#ifdef ARDUINO
+class SFE_MMC5983MA_SPI_Transport
+{
+private:
+  SPIClass *_spiPort = nullptr;
+  uint8_t _csPin = 0;
+  SPISettings _mmcSpiSettings;
+
+  // See holdTransaction()
+  bool transactionHeld = false;
+  bool transactionOwned = false;
+
+  void beginTransaction()
+  {
+    if (!transactionHeld)
+      _spiPort->beginTransaction(_mmcSpiSettings);
+  }
+
+  void endTransaction()
+  {
+    if (!transactionHeld)
+      _spiPort->endTransaction();
+  }
+
+  // Read operations must have the most significant bit set
+  static uint8_t readRegister(const uint8_t registerAddress)
+  {
+    return (0x80 | registerAddress);
+  }
+
+public:
+  void begin(const uint8_t csPin, SPISettings userSettings, SPIClass &spiPort)
+  {
+    _csPin = csPin;
+    digitalWrite(_csPin, HIGH);
+    pinMode(_csPin, OUTPUT);
+    _spiPort = &spiPort;
+    _mmcSpiSettings = userSettings;
+  }
+
+  // Keeps one SPI transaction open across calls until releaseTransaction().
+  // If ownTransaction is false, the transaction has already been started by another
+  // sensor on the same SPI bus (with the same settings) and is only shared.
+  void holdTransaction(bool ownTransaction)
+  {
+    if (transactionHeld)
+      return;
+    if (ownTransaction)
+      _spiPort->beginTransaction(_mmcSpiSettings);
+    transactionOwned = ownTransaction;
+    transactionHeld = true;
+  }
+
+  // Ends a transaction started by holdTransaction()
+  void releaseTransaction()
+  {
+    if (!transactionHeld)
+      return;
+    transactionHeld = false;
+    if (transactionOwned)
+      _spiPort->endTransaction();
+  }
+
+  bool isConnected()
+  {
+    uint8_t readback = 0;
+    readSingleByte(PROD_ID_REG, &readback);
+    return (readback == PROD_ID);
+  }
+
+  bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+  {
+    beginTransaction();
+    digitalWrite(_csPin, LOW);
+    _spiPort->transfer(registerAddress);
+    _spiPort->transfer(buffer, packetLength);
+    digitalWrite(_csPin, HIGH);
+    endTransaction();
+    return true;
+  }
+
+  bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength)
+  {
+    beginTransaction();
+    digitalWrite(_csPin, LOW);
+    _spiPort->transfer(readRegister(registerAddress));
+    _spiPort->transfer(buffer, packetLength);
+    digitalWrite(_csPin, HIGH);
+    endTransaction();
+    return true;
+  }
+
+  bool readSingleByte(const uint8_t registerAddress, uint8_t *buffer)
+  {
+    beginTransaction();
+    digitalWrite(_csPin, LOW);
+    _spiPort->transfer(readRegister(registerAddress));
+    *buffer = _spiPort->transfer(DUMMY);
+    digitalWrite(_csPin, HIGH);
+    endTransaction();
+    return true;
+  }
+
+  bool writeSingleByte(const uint8_t registerAddress, const uint8_t value)
+  {
+    beginTransaction();
+    digitalWrite(_csPin, LOW);
+    _spiPort->transfer(registerAddress);
+    _spiPort->transfer(value);
+    digitalWrite(_csPin, HIGH);
+    endTransaction();
+    return true;
+  }
+};
+#endif
+
+#endif
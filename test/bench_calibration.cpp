@@ -0,0 +1,120 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file benchmarks SFE_MMC5983MA_Calibration against the same hard-iron offset and soft-iron
+  matrix applied in double. Both loops read pseudo-random raw fields from an array and write their
+  results to volatile variables, so they do the same work and neither can be hoisted or dropped.
+  It reports the time per sample for each, and the largest difference between them over 1M random
+  inputs. Run it with: make -C test bench
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Calibration.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const int32_t MID_SCALE = 131072;
+static const double MICROGAUSS_PER_COUNT = 15625.0 / 256.0;
+
+static const int32_t hardIron[3] = {1234, -567, 89};
+static const int32_t softIron[3][3] = {
+    {70000, -1200, 300},
+    {-1200, 61000, 800},
+    {300, 800, 66500}};
+
+static const size_t SAMPLES = 1024;
+static const unsigned PASSES = 10000;
+
+static uint32_t randomState = 1;
+
+static uint32_t randomField()
+{
+    randomState = (randomState * 1664525UL) + 1013904223UL;
+    return (randomState >> 8) % 262144;
+}
+
+int main()
+{
+    SFE_MMC5983MA_Calibration calibration;
+    calibration.setOffset(hardIron[0], hardIron[1], hardIron[2]);
+    calibration.setMatrix(softIron);
+
+    double doubleMatrix[3][3];
+    for (int row = 0; row < 3; row++)
+    {
+        for (int column = 0; column < 3; column++)
+            doubleMatrix[row][column] = softIron[row][column] / 65536.0 * MICROGAUSS_PER_COUNT;
+    }
+
+    std::vector<uint32_t> raw(SAMPLES * 3);
+    for (size_t i = 0; i < raw.size(); i++)
+        raw[i] = randomField();
+
+    // Fixed point
+    volatile int32_t fixedSink[3];
+    Clock::time_point start = Clock::now();
+    for (unsigned pass = 0; pass < PASSES; pass++)
+    {
+        for (size_t i = 0; i < SAMPLES; i++)
+        {
+            int32_t x, y, z;
+            calibration.apply(raw[i * 3], raw[i * 3 + 1], raw[i * 3 + 2], &x, &y, &z);
+            fixedSink[0] = x;
+            fixedSink[1] = y;
+            fixedSink[2] = z;
+        }
+    }
+    double fixedNanos = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (PASSES * SAMPLES);
+
+    // Double: the same offset and matrix
+    volatile double doubleSink[3];
+    start = Clock::now();
+    for (unsigned pass = 0; pass < PASSES; pass++)
+    {
+        for (size_t i = 0; i < SAMPLES; i++)
+        {
+            double counts[3];
+            for (int axis = 0; axis < 3; axis++)
+                counts[axis] = (double)raw[i * 3 + axis] - MID_SCALE - hardIron[axis];
+            for (int row = 0; row < 3; row++)
+                doubleSink[row] = doubleMatrix[row][0] * counts[0] + doubleMatrix[row][1] * counts[1] + doubleMatrix[row][2] * counts[2];
+        }
+    }
+    double doubleNanos = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (PASSES * SAMPLES);
+    (void)fixedSink;
+    (void)doubleSink;
+
+    // Accuracy against the double result
+    double worstError = 0;
+    for (unsigned i = 0; i < 1000000; i++)
+    {
+        uint32_t field[3] = {randomField(), randomField(), randomField()};
+        int32_t fixed[3];
+        calibration.apply(field[0], field[1], field[2], &fixed[0], &fixed[1], &fixed[2]);
+
+        for (int row = 0; row < 3; row++)
+        {
+            double exact = 0;
+            for (int column = 0; column < 3; column++)
+                exact += doubleMatrix[row][column] * ((double)field[column] - MID_SCALE - hardIron[column]);
+            if (fabs(fixed[row] - exact) > worstError)
+                worstError = fabs(fixed[row] - exact);
+        }
+    }
+
+    printf("fixed point (offset + matrix): %.2f ns per sample\n", fixedNanos);
+    printf("double (offset + matrix):      %.2f ns per sample\n", doubleNanos);
+    printf("largest difference over 1M random inputs: %.2f uG\n", worstError);
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file benchmarks SFE_MMC5983MA_LatestFrame against a mutex-protected copy of the same
+  sample. A publisher thread stores a frame every millisecond (the 1000Hz continuous mode rate)
+  while reader threads take snapshots as fast as they can. It reports the snapshots taken per
+  second and the worst time the publisher spent storing a frame. Run it with: make -C test bench
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_LatestFrame.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static void run(bool useMutex, unsigned readers)
+{
+    SFE_MMC5983MA_LatestFrame slot;
+    std::mutex lock;
+    SFE_MMC5983MA_Sample shared;
+
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> snapshots(0);
+    std::atomic<int64_t> worstPublish(0);
+
+    std::thread publisher([&]() {
+        Clock::time_point next = Clock::now();
+        SFE_MMC5983MA_Frame frame;
+        for (uint32_t i = 1; !stop; i++)
+        {
+            frame.x = i;
+
+            Clock::time_point start = Clock::now();
+            if (useMutex)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                shared.frame = frame;
+                shared.timestamp = i;
+                shared.sequence = i;
+            }
+            else
+                slot.publish(frame, i);
+            int64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+            if (duration > worstPublish)
+                worstPublish = duration;
+
+            next += std::chrono::microseconds(1000);
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    std::vector<std::thread> readerThreads;
+    for (unsigned r = 0; r < readers; r++)
+    {
+        readerThreads.emplace_back([&]() {
+            SFE_MMC5983MA_Sample sample;
+            uint64_t count = 0;
+            while (!stop)
+            {
+                if (useMutex)
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    sample = shared;
+                }
+                else
+                    slot.read(&sample);
+                count++;
+            }
+            snapshots += count;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    stop = true;
+    publisher.join();
+    for (size_t r = 0; r < readerThreads.size(); r++)
+        readerThreads[r].join();
+
+    printf("%s %u reader(s): %.1f million snapshots/s, worst publish %lld ns\n", useMutex ? "mutex  " : "seqlock",
+           readers, snapshots.load() / 1e6, (long long)worstPublish.load());
+}
+
+int main()
+{
+    static const unsigned readerCounts[] = {1, 2, 4};
+
+    printf("%u hardware thread(s)\n", std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < 3; i++)
+    {
+        run(false, readerCounts[i]);
+        run(true, readerCounts[i]);
+    }
+    return 0;
+}
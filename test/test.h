@@ -0,0 +1,45 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file declares the minimal checks used by the host tests (see the Makefile).
+  CHECK() reports a failed condition and carries on; main() returns testResult().
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#ifndef _SPARKFUN_MMC5983MA_TEST_
+#define _SPARKFUN_MMC5983MA_TEST_
+
+#include <stdio.h>
+
+static int testFailures = 0;
+
+#define CHECK(condition)                                                          \
+  do                                                                              \
+  {                                                                               \
+    if (!(condition))                                                             \
+    {                                                                             \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);        \
+      testFailures++;                                                             \
+    }                                                                             \
+  } while (0)
+
+// Prints the outcome and returns the exit code for main()
+static int testResult()
+{
+  if (testFailures != 0)
+  {
+    printf("%d check(s) failed\n", testFailures);
+    return 1;
+  }
+
+  printf("ok\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,221 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file tests SFE_MMC5983MA_Broadcast: first single-threaded, then under stress, with a
+  producer thread publishing frames while three subscriber threads read them in place (two
+  fast, one which stalls on every batch). Every frame's fields are derived from its number,
+  so a torn or overwritten frame shows. The subscribers check that:
+    the frames in each batch they keep are intact and in order
+    release() returns false for every batch in which a frame was overwritten
+    the frames they released plus the frames counted as dropped are exactly the frames published
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Broadcast.h"
+#include "test.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static const uint32_t FRAMES = 200000;
+
+typedef SFE_MMC5983MA_Broadcast<64, 3> Broadcast;
+
+// The frame published as number i
+static SFE_MMC5983MA_Frame makeFrame(uint32_t i)
+{
+    SFE_MMC5983MA_Frame frame;
+    frame.x = i;
+    frame.y = i * 3;
+    frame.z = ~i;
+    frame.temperature = (uint8_t)i;
+    frame.status = (uint8_t)(i >> 8);
+    return frame;
+}
+
+// True if the frame and its timestamp are frame number i, intact
+static bool isFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp, uint32_t i)
+{
+    return (frame.x == i) && (frame.y == i * 3) && (frame.z == ~i) && (frame.temperature == (uint8_t)i) &&
+           (frame.status == (uint8_t)(i >> 8)) && (timestamp == i * 7);
+}
+
+static void testSingleThread()
+{
+    Broadcast broadcast;
+    const SFE_MMC5983MA_Frame *frames = nullptr;
+    const uint32_t *timestamps = nullptr;
+
+    int8_t first = broadcast.subscribe();
+    int8_t second = broadcast.subscribe();
+    int8_t third = broadcast.subscribe();
+    CHECK((first == 0) && (second == 1) && (third == 2));
+    CHECK(broadcast.subscribe() == -1);
+
+    CHECK(broadcast.peek(first, &frames) == 0);
+
+    // A run stops at the end of the ring: 40 frames from slot 0, then 40 from slot 40 in two runs
+    for (uint32_t i = 0; i < 40; i++)
+        broadcast.publish(makeFrame(i), i * 7);
+    CHECK(broadcast.available(first) == 40);
+    CHECK(broadcast.peek(first, &frames, &timestamps) == 40);
+    CHECK(isFrame(frames[0], timestamps[0], 0) && isFrame(frames[39], timestamps[39], 39));
+    CHECK(broadcast.release(first, 40));
+
+    for (uint32_t i = 40; i < 80; i++)
+        broadcast.publish(makeFrame(i), i * 7);
+    CHECK(broadcast.peek(first, &frames, &timestamps) == 24);
+    CHECK(isFrame(frames[0], timestamps[0], 40));
+    CHECK(broadcast.release(first, 24));
+    CHECK(broadcast.peek(first, &frames, &timestamps) == 16);
+    CHECK(isFrame(frames[0], timestamps[0], 64));
+    CHECK(broadcast.release(first, 16));
+    CHECK(broadcast.getDroppedFrames(first) == 0);
+
+    // second has not read anything: 80 waiting, more than the ring holds. It skips to half a ring
+    // behind (frame 48), and the run stops at the end of the ring.
+    CHECK(broadcast.available(second) == 80);
+    CHECK(broadcast.peek(second, &frames, &timestamps) == 16);
+    CHECK(broadcast.getDroppedFrames(second) == 48);
+    CHECK(isFrame(frames[0], timestamps[0], 48));
+
+    // A batch overwritten while it is held is reported
+    for (uint32_t i = 80; i < 200; i++)
+        broadcast.publish(makeFrame(i), i * 7);
+    CHECK(!broadcast.release(second, 16));
+    CHECK(broadcast.getOverwrittenBatches(second) == 1);
+
+    // Unsubscribed slots are reused, and start at the head
+    broadcast.unsubscribe(third);
+    CHECK(broadcast.subscribe() == third);
+    CHECK(broadcast.available(third) == 0);
+    CHECK(broadcast.getPublished() == 200);
+}
+
+struct SubscriberResult
+{
+    uint32_t released = 0;
+    uint32_t keptBatches = 0;
+    uint32_t rejectedBatches = 0;
+    uint32_t badKeptBatches = 0;    // Batches with a bad frame which release() accepted
+    uint32_t lostFrames = 0;        // Frames skipped without being counted as dropped
+};
+
+static void subscriberThread(Broadcast &broadcast, uint8_t subscriber, uint32_t stallMicros, std::atomic<bool> &producerDone, SubscriberResult &result)
+{
+    // The frame number of the next unread frame
+    uint32_t next = 0;
+    uint32_t dropped = 0;
+
+    while (true)
+    {
+        bool done = producerDone;
+
+        const SFE_MMC5983MA_Frame *frames = nullptr;
+        const uint32_t *timestamps = nullptr;
+        uint32_t length = broadcast.peek(subscriber, &frames, &timestamps);
+
+        // Frames skipped by peek() must all be counted as dropped
+        uint32_t newlyDropped = broadcast.getDroppedFrames(subscriber) - dropped;
+        dropped += newlyDropped;
+        next += newlyDropped;
+
+        if (length == 0)
+        {
+            if (done)
+                break;
+            std::this_thread::yield();
+            continue;
+        }
+
+        bool intact = true;
+        for (uint32_t i = 0; i < length; i++)
+        {
+            SFE_MMC5983MA_Frame frame = frames[i];
+            uint32_t timestamp = timestamps[i];
+            if (!isFrame(frame, timestamp, next + i))
+                intact = false;
+        }
+
+        if (stallMicros > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(stallMicros));
+
+        if (broadcast.release(subscriber, length))
+        {
+            result.keptBatches++;
+            if (!intact)
+                result.badKeptBatches++;
+        }
+        else
+            result.rejectedBatches++;
+
+        result.released += length;
+        next += length;
+    }
+
+    // Every frame published was either released or counted as dropped
+    if (next != FRAMES)
+        result.lostFrames = FRAMES - next;
+}
+
+static void testStress()
+{
+    Broadcast broadcast;
+    std::atomic<bool> producerDone(false);
+    SubscriberResult results[3];
+    const uint32_t stalls[3] = {0, 0, 2000};
+
+    // Subscribe before any frame is published, so every subscriber starts at frame 0
+    for (uint8_t i = 0; i < 3; i++)
+        CHECK(broadcast.subscribe() == i);
+
+    std::thread subscribers[3];
+    for (uint8_t i = 0; i < 3; i++)
+        subscribers[i] = std::thread(subscriberThread, std::ref(broadcast), i, stalls[i], std::ref(producerDone), std::ref(results[i]));
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < FRAMES; i++)
+        {
+            broadcast.publish(makeFrame(i), i * 7);
+
+            // Bursts longer than the ring, so the fast subscribers fall behind now and then too
+            if ((i % 100) == 0)
+                std::this_thread::yield();
+        }
+        producerDone = true;
+    });
+
+    producer.join();
+    for (uint8_t i = 0; i < 3; i++)
+        subscribers[i].join();
+
+    CHECK(broadcast.getPublished() == FRAMES);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        printf("  subscriber %u: %u released in %u batches, %u dropped, %u batches overwritten\n", i, results[i].released,
+               results[i].keptBatches + results[i].rejectedBatches, broadcast.getDroppedFrames(i), results[i].rejectedBatches);
+
+        CHECK(results[i].badKeptBatches == 0);
+        CHECK(results[i].lostFrames == 0);
+        CHECK(results[i].released + broadcast.getDroppedFrames(i) == FRAMES);
+        CHECK(results[i].rejectedBatches == broadcast.getOverwrittenBatches(i));
+    }
+
+    // The stalled subscriber cannot keep up: it must have been told
+    CHECK(broadcast.getDroppedFrames(2) > 0);
+    CHECK(broadcast.getOverwrittenBatches(2) > 0);
+}
+
+int main()
+{
+    testSingleThread();
+    testStress();
+    return testResult();
+}
@@ -0,0 +1,225 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file tests SFE_MMC5983MA_Decimator: the factor limits, that output is only written with a
+  result, DC and step responses, every output against a direct convolution with the CIC impulse
+  response (across integrator wrap), and the noise reduction on white noise of sd 6.5 counts at
+  factor 10 for a boxcar and for CIC3.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Decimator.h"
+#include "test.h"
+
+#include <math.h>
+#include <vector>
+
+static const uint32_t MID_SCALE = 131072;
+
+static uint32_t randomState = 1;
+
+static uint32_t randomWord()
+{
+    randomState = (randomState * 1664525UL) + 1013904223UL;
+    return randomState >> 8;
+}
+
+// Normally distributed, by Box-Muller
+static double randomNormal(double sd)
+{
+    double u1 = (randomWord() + 1.0) / 16777217.0;
+    double u2 = randomWord() / 16777216.0;
+    return sd * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static SFE_MMC5983MA_Frame makeFrame(uint32_t x, uint32_t y, uint32_t z)
+{
+    SFE_MMC5983MA_Frame frame = {};
+    frame.x = x;
+    frame.y = y;
+    frame.z = z;
+    return frame;
+}
+
+// The CIC impulse response: Order boxcars of length factor, convolved
+static std::vector<uint64_t> impulseResponse(uint8_t order, uint16_t factor)
+{
+    std::vector<uint64_t> response(1, 1);
+    for (uint8_t stage = 0; stage < order; stage++)
+    {
+        std::vector<uint64_t> next(response.size() + factor - 1, 0);
+        for (size_t i = 0; i < response.size(); i++)
+        {
+            for (uint16_t j = 0; j < factor; j++)
+                next[i + j] += response[i];
+        }
+        response = next;
+    }
+    return response;
+}
+
+static void testFactor()
+{
+    SFE_MMC5983MA_Decimator<3> cic;
+    CHECK(cic.getFactor() == 10);
+    CHECK(!cic.setFactor(0));
+    CHECK(cic.setFactor(25));  // 15625
+    CHECK(!cic.setFactor(26)); // 17576
+    CHECK(cic.getFactor() == 25);
+
+    SFE_MMC5983MA_Decimator<1> boxcar(100);
+    CHECK(boxcar.getFactor() == 100);
+}
+
+// Checks every output of a decimator against the direct convolution of its inputs
+template <uint8_t Order>
+static void testConvolution(uint16_t factor)
+{
+    SFE_MMC5983MA_Decimator<Order> decimator(factor);
+    std::vector<uint64_t> response = impulseResponse(Order, factor);
+    uint64_t gain = 1;
+    for (uint8_t stage = 0; stage < Order; stage++)
+        gain *= factor;
+
+    // Full-scale random inputs, long enough for the integrators to wrap many times. z is independent of x.
+    std::vector<uint32_t> xInputs, zInputs;
+    uint32_t outputs = 0;
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+        xInputs.push_back(randomWord() % 262144);
+        zInputs.push_back(randomWord() % 262144);
+
+        SFE_MMC5983MA_Frame output;
+        if (!decimator.push(makeFrame(xInputs[i], MID_SCALE, zInputs[i]), &output))
+            continue;
+        outputs++;
+
+        uint64_t xSum = 0, zSum = 0;
+        for (size_t j = 0; (j < response.size()) && (j <= i); j++)
+        {
+            xSum += response[j] * xInputs[i - j];
+            zSum += response[j] * zInputs[i - j];
+        }
+        if ((output.x != (uint32_t)((xSum + (gain / 2)) / gain)) || (output.y != MID_SCALE) ||
+            (output.z != (uint32_t)((zSum + (gain / 2)) / gain)))
+            wrong++;
+    }
+
+    CHECK(outputs == (uint32_t)((20000 / factor) - (Order - 1)));
+    CHECK(wrong == 0);
+}
+
+static void testUntouched()
+{
+    // output is only written when push() returns true, including during warm-up
+    SFE_MMC5983MA_Decimator<3> cic(4);
+    SFE_MMC5983MA_Frame output = makeFrame(1, 2, 3);
+    output.temperature = 4;
+    output.status = 5;
+    uint32_t changed = 0;
+
+    for (uint32_t i = 0; i < 4 * 3; i++)
+    {
+        bool produced = cic.push(makeFrame(MID_SCALE, MID_SCALE, MID_SCALE), &output);
+        if (!produced && ((output.x != 1) || (output.y != 2) || (output.z != 3) || (output.temperature != 4) || (output.status != 5)))
+            changed++;
+        if (produced)
+            CHECK(i == (4 * 3) - 1);
+    }
+    CHECK(changed == 0);
+    CHECK(output.x == MID_SCALE);
+}
+
+static void testSteps()
+{
+    SFE_MMC5983MA_Decimator<3> cic(4);
+    SFE_MMC5983MA_Frame output;
+    uint32_t outputs = 0;
+    uint32_t wrongDC = 0;
+
+    // DC in gives exactly DC out, from the first output
+    for (uint32_t i = 0; i < 400; i++)
+    {
+        if (cic.push(makeFrame(0, 262143, MID_SCALE + 1234), &output))
+        {
+            outputs++;
+            if ((output.x != 0) || (output.y != 262143) || (output.z != MID_SCALE + 1234))
+                wrongDC++;
+        }
+    }
+    CHECK(outputs == 98);
+    CHECK(wrongDC == 0);
+
+    // A step down settles exactly after Order outputs, without overshoot
+    uint32_t previous = output.z;
+    bool monotonic = true;
+    for (uint32_t i = 0; i < 4 * 3; i++)
+    {
+        if (cic.push(makeFrame(0, 262143, MID_SCALE - 5000), &output))
+        {
+            if (output.z > previous)
+                monotonic = false;
+            previous = output.z;
+        }
+    }
+    CHECK(monotonic);
+    CHECK(output.z == MID_SCALE - 5000);
+}
+
+// Returns the standard deviation of the x outputs for white noise of sd 6.5 counts
+template <uint8_t Order>
+static double outputNoise(uint16_t factor)
+{
+    SFE_MMC5983MA_Decimator<Order> decimator(factor);
+    double sum = 0, squares = 0;
+    uint32_t outputs = 0;
+
+    for (uint32_t i = 0; i < 400000; i++)
+    {
+        uint32_t value = (uint32_t)lround(MID_SCALE + randomNormal(6.5));
+        SFE_MMC5983MA_Frame output;
+        if (decimator.push(makeFrame(value, value, value), &output))
+        {
+            double deviation = (double)output.x - MID_SCALE;
+            sum += deviation;
+            squares += deviation * deviation;
+            outputs++;
+        }
+    }
+
+    double mean = sum / outputs;
+    return sqrt((squares / outputs) - (mean * mean));
+}
+
+static void testNoise()
+{
+    double input = outputNoise<1>(1);
+    double boxcar = outputNoise<1>(10);
+    double cic = outputNoise<3>(10);
+    printf("  white noise sd %.2f: factor 10 boxcar %.2f, CIC3 %.2f\n", input, boxcar, cic);
+
+    // 6.5 / sqrt(10) = 2.06, and the CIC3 window's noise gain is 0.24 (sd 1.57), each plus rounding
+    CHECK(fabs(input - 6.5) < 0.1);
+    CHECK(fabs(boxcar - 2.10) < 0.1);
+    CHECK(fabs(cic - 1.57) < 0.1);
+}
+
+int main()
+{
+    testFactor();
+    testConvolution<1>(10);
+    testConvolution<2>(7);
+    testConvolution<3>(10);
+    testConvolution<4>(8);
+    testUntouched();
+    testSteps();
+    testNoise();
+    return testResult();
+}
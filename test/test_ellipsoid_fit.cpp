@@ -0,0 +1,176 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file tests SFE_MMC5983MA_EllipsoidFit on samples of a 0.5 Gauss field in random directions,
+  distorted by a known soft-iron matrix and hard-iron offset, with +/-3 counts of noise. It checks
+  the fitted offset, the residuals of the calibrated samples, getFitError() against the injected
+  noise, the coverage, a hard-iron offset as large as the field (fitted about the previous offset),
+  and the cases which must not solve.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_EllipsoidFit.h"
+#include "test.h"
+
+#include <math.h>
+
+static const int32_t MID_SCALE = 131072;
+static const double FIELD = 8192.0; // 0.5 Gauss, in counts
+static const double MICROGAUSS_PER_COUNT = 15625.0 / 256.0;
+
+// Soft iron: symmetric, with determinant 0.9967. The fit scales the corrected field to the
+// geometric mean of the semi-axes, FIELD * cbrt(0.9967).
+static const double distortion[3][3] = {
+    {1.10, 0.05, -0.03},
+    {0.05, 0.92, 0.04},
+    {-0.03, 0.04, 0.99}};
+
+static double expectedField()
+{
+    double determinant = (distortion[0][0] * ((distortion[1][1] * distortion[2][2]) - (distortion[1][2] * distortion[2][1]))) -
+                         (distortion[0][1] * ((distortion[1][0] * distortion[2][2]) - (distortion[1][2] * distortion[2][0]))) +
+                         (distortion[0][2] * ((distortion[1][0] * distortion[2][1]) - (distortion[1][1] * distortion[2][0])));
+    return FIELD * cbrt(determinant);
+}
+
+static uint32_t randomState = 1;
+
+static uint32_t randomWord()
+{
+    randomState = (randomState * 1664525UL) + 1013904223UL;
+    return randomState >> 8;
+}
+
+// Uniform in [-1, 1)
+static double randomUniform()
+{
+    return (randomWord() / 8388608.0) - 1.0;
+}
+
+// A raw sample of the distorted field in a random direction. In a plane (z = 0) if planar.
+static void makeSample(const int32_t offset[3], uint32_t raw[3], bool planar = false)
+{
+    double direction[3];
+    double length;
+    do
+    {
+        for (uint8_t axis = 0; axis < 3; axis++)
+            direction[axis] = randomUniform();
+        if (planar)
+            direction[2] = 0.0;
+        length = sqrt((direction[0] * direction[0]) + (direction[1] * direction[1]) + (direction[2] * direction[2]));
+    } while ((length > 1.0) || (length < 0.1));
+
+    for (uint8_t row = 0; row < 3; row++)
+    {
+        double value = 0.0;
+        for (uint8_t column = 0; column < 3; column++)
+            value += distortion[row][column] * direction[column] / length * FIELD;
+        raw[row] = (uint32_t)(MID_SCALE + offset[row] + lround(value) + (int32_t)(randomWord() % 7) - 3);
+    }
+}
+
+// Fits 2000 samples, then checks the residuals of 2000 more through the calibration
+static void testFit(const int32_t offset[3], bool aboutOffset)
+{
+    SFE_MMC5983MA_EllipsoidFit fit;
+    if (aboutOffset)
+        fit.reset(offset[0] + 400, offset[1] - 300, offset[2] + 200);
+
+    uint32_t raw[3];
+    for (uint16_t i = 0; i < 2000; i++)
+    {
+        makeSample(offset, raw);
+        fit.addSample(raw[0], raw[1], raw[2]);
+    }
+    CHECK(fit.getSampleCount() == 2000);
+    CHECK(fit.getCoverage() >= 80);
+    CHECK(fit.solve());
+
+    int32_t x, y, z;
+    fit.getOffset(&x, &y, &z);
+    CHECK((abs(x - offset[0]) <= 2) && (abs(y - offset[1]) <= 2) && (abs(z - offset[2]) <= 2));
+    CHECK(fabs(fit.getFieldStrength() - expectedField()) < FIELD * 0.0002);
+
+    SFE_MMC5983MA_Calibration calibration;
+    CHECK(fit.applyTo(calibration));
+
+    double sum = 0, squares = 0, worst = 0;
+    for (uint16_t i = 0; i < 2000; i++)
+    {
+        makeSample(offset, raw);
+        int32_t field[3];
+        calibration.apply(raw[0], raw[1], raw[2], &field[0], &field[1], &field[2]);
+        double strength = sqrt(((double)field[0] * field[0]) + ((double)field[1] * field[1]) + ((double)field[2] * field[2]));
+        double residual = (strength / (expectedField() * MICROGAUSS_PER_COUNT)) - 1.0;
+        sum += residual;
+        squares += residual * residual;
+        if (fabs(residual) > worst)
+            worst = fabs(residual);
+    }
+    double rms = sqrt(squares / 2000);
+
+    printf("  offset (%d, %d, %d): residual %.4f%% RMS, %.4f%% worst, mean %.4f%%; getFitError() %.4f%%\n", offset[0], offset[1],
+           offset[2], rms * 100, worst * 100, sum / 2000 * 100, fit.getFitError() * 100);
+
+    // The noise alone, +/-3 counts (sd 2) on each axis, is 0.024% RMS of the radius
+    CHECK(rms < 0.0004);
+    CHECK(worst < 0.001);
+    CHECK(fabs(sum / 2000) < 0.0002);
+    CHECK((fit.getFitError() > 0.0001) && (fit.getFitError() < 0.0005));
+}
+
+static void testDegenerate()
+{
+    SFE_MMC5983MA_EllipsoidFit fit;
+    const int32_t offset[3] = {100, 200, 300};
+    uint32_t raw[3];
+
+    // Nothing solved yet: unit matrix, no offset, and nothing to apply
+    int32_t matrix[3][3];
+    fit.getMatrix(matrix);
+    CHECK((matrix[0][0] == 65536) && (matrix[0][1] == 0) && (matrix[2][2] == 65536));
+    SFE_MMC5983MA_Calibration calibration;
+    CHECK(!fit.applyTo(calibration));
+
+    // Too few samples
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        makeSample(offset, raw);
+        fit.addSample(raw[0], raw[1], raw[2]);
+    }
+    CHECK(!fit.solve());
+
+    // Turned in one plane only: the normal equations are singular
+    fit.reset();
+    for (uint16_t i = 0; i < 500; i++)
+    {
+        makeSample(offset, raw, true);
+        fit.addSample(raw[0], raw[1], raw[2]);
+    }
+    CHECK(fit.getCoverage() < 50);
+    CHECK(!fit.solve());
+    CHECK(fit.getFitError() == 0.0);
+
+    // A stationary sensor: noise alone does not count as coverage
+    fit.reset();
+    for (uint16_t i = 0; i < 500; i++)
+        fit.addSample(MID_SCALE + 5000 + (randomWord() % 200), MID_SCALE + (randomWord() % 200), MID_SCALE + (randomWord() % 200));
+    CHECK(fit.getCoverage() == 0);
+}
+
+int main()
+{
+    const int32_t small[3] = {1234, -567, 890};
+    const int32_t large[3] = {9000, -4000, 2500};
+    testFit(small, false);
+    testFit(large, true);
+    testDegenerate();
+    return testResult();
+}
@@ -0,0 +1,190 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file tests SFE_MMC5983MA_LatestFrame and the frame sinks: as a sink on the driver and
+  behind the SET/RESET differential mode, then under stress,
+  with a publisher thread storing frames as fast as it can while reader threads check that every
+  snapshot they get is consistent (all fields from the same publish) and never goes backwards.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Differential.h"
+#include "SparkFun_MMC5983MA_LatestFrame.h"
+#include "SparkFun_MMC5983MA_Simulator.h"
+#include "test.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static const int32_t MID_SCALE = 131072;
+
+static void testDriverSink()
+{
+    SFE_MMC5983MA_Simulator sim;
+    SFE_MMC5983MA mag;
+    SFE_MMC5983MA_LatestFrame latest;
+    SFE_MMC5983MA_Sample sample;
+    sim.setField(1000, -2000, 3000);
+
+    CHECK(mag.begin(sim));
+    mag.addFrameSink(&latest);
+
+    // Nothing published yet
+    CHECK(!latest.read(&sample));
+    CHECK(!latest.tryRead(&sample));
+
+    uint32_t x = 0, y = 0, z = 0;
+    CHECK(mag.getMeasurementXYZ(&x, &y, &z));
+    CHECK(latest.read(&sample));
+    CHECK(sample.sequence == 1);
+    CHECK((int32_t)sample.frame.x - MID_SCALE == 1000);
+    CHECK(sample.frame.status == MEAS_M_DONE);
+
+    // Stamped with the bus time while the frame is read
+    SFE_MMC5983MA_Frame frame;
+    CHECK(mag.startMeasurement());
+    CHECK(mag.waitUntilMeasurementReady());
+    uint32_t before = sim.getMicros();
+    CHECK(mag.readFrame(&frame));
+    uint32_t after = sim.getMicros();
+    CHECK(latest.read(&sample));
+    CHECK(sample.sequence == 2);
+    CHECK((int32_t)sample.frame.z - MID_SCALE == 3000);
+    CHECK((sample.timestamp >= before) && (sample.timestamp <= after));
+
+    // Once removed, the slot keeps the last frame it was given
+    mag.removeFrameSink(&latest);
+    CHECK(mag.getMeasurementXYZ(&x, &y, &z));
+    CHECK(latest.read(&sample));
+    CHECK(sample.sequence == 2);
+}
+
+// Checks every frame it is given against the expected field
+class FieldCheckSink : public SFE_MMC5983MA_FrameSink
+{
+public:
+  int32_t field[3] = {0, 0, 0};
+  uint32_t frames = 0;
+  uint32_t wrongFrames = 0;
+
+  void onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp) override
+  {
+    (void)timestamp;
+    frames++;
+    if (((int32_t)frame.x - MID_SCALE != field[0]) || ((int32_t)frame.y - MID_SCALE != field[1]) ||
+        ((int32_t)frame.z - MID_SCALE != field[2]) || (frame.status != MEAS_M_DONE))
+      wrongFrames++;
+  }
+};
+
+static void testDifferentialSink()
+{
+    SFE_MMC5983MA_Simulator sim;
+    SFE_MMC5983MA mag;
+    SFE_MMC5983MA_Differential differential(mag);
+    FieldCheckSink sink;
+    sim.setField(1000, -2000, 3000);
+    sim.setBridgeOffset(300, -150, 75);
+    sink.field[0] = 1000;
+    sink.field[1] = -2000;
+    sink.field[2] = 3000;
+
+    CHECK(mag.begin(sim));
+    CHECK(mag.setFilterBandwidth(800));
+    mag.addFrameSink(&sink);
+
+    // One frame per sample, all offset-free: the RESET reads (-H + offset) and the raw SET reads are kept back
+    differential.setEstimateInterval(10);
+    for (uint8_t i = 0; i < 50; i++)
+    {
+        uint32_t x = 0, y = 0, z = 0;
+        CHECK(differential.getMeasurementXYZ(&x, &y, &z));
+    }
+
+    CHECK(differential.getEstimateCount() == 5);
+    CHECK(sink.frames == 50);
+    CHECK(sink.wrongFrames == 0);
+}
+
+// The frame published as number i: every field is derived from i, so a torn snapshot shows
+static SFE_MMC5983MA_Frame makeFrame(uint32_t i)
+{
+    SFE_MMC5983MA_Frame frame;
+    frame.x = i;
+    frame.y = i * 3;
+    frame.z = ~i;
+    frame.temperature = (uint8_t)i;
+    frame.status = (uint8_t)(i >> 8);
+    return frame;
+}
+
+static bool isConsistent(const SFE_MMC5983MA_Sample &sample)
+{
+    uint32_t i = sample.frame.x;
+    return (sample.frame.y == i * 3) && (sample.frame.z == ~i) && (sample.frame.temperature == (uint8_t)i) &&
+           (sample.frame.status == (uint8_t)(i >> 8)) && (sample.timestamp == i * 7) && (sample.sequence == i);
+}
+
+static void testStress(unsigned readers)
+{
+    SFE_MMC5983MA_LatestFrame slot;
+    std::atomic<bool> stop(false);
+    std::atomic<uint32_t> snapshots(0);
+    std::atomic<uint32_t> torn(0);
+    std::atomic<uint32_t> backwards(0);
+
+    std::thread publisher([&]() {
+        for (uint32_t i = 1; !stop; i++)
+            slot.publish(makeFrame(i), i * 7);
+    });
+
+    std::vector<std::thread> readerThreads;
+    for (unsigned r = 0; r < readers; r++)
+    {
+        readerThreads.emplace_back([&]() {
+            SFE_MMC5983MA_Sample sample;
+            uint32_t last = 0;
+            while (!stop)
+            {
+                if (!slot.tryRead(&sample))
+                    continue;
+
+                snapshots++;
+                if (!isConsistent(sample))
+                    torn++;
+                if (sample.sequence < last)
+                    backwards++;
+                last = sample.sequence;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    stop = true;
+    publisher.join();
+    for (size_t r = 0; r < readerThreads.size(); r++)
+        readerThreads[r].join();
+
+    printf("  %u reader(s): %u snapshots\n", readers, snapshots.load());
+    CHECK(snapshots > 0);
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+}
+
+int main()
+{
+    testDriverSink();
+    testDifferentialSink();
+    testStress(1);
+    testStress(2);
+    testStress(4);
+    return testResult();
+}
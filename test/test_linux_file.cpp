@@ -0,0 +1,281 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file tests the Linux userspace transports through a fake SFE_MMC5983MA_LinuxFile: a file
+  descriptor which is not backed by any device, with the spidev and i2c-dev ioctls answered by
+  SFE_MMC5983MA_Simulator. It checks the descriptor handling, the messages built for each bus,
+  error paths, and the sleep used as the bus time base.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+#include "SparkFun_MMC5983MA_Linux.h"
+#include "SparkFun_MMC5983MA_Simulator.h"
+#include "test.h"
+
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <linux/spi/spidev.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+
+static const int32_t MID_SCALE = 131072;
+
+// A device file which only exists in this process
+class FakeFile : public SFE_MMC5983MA_LinuxFile
+{
+public:
+  static const int FAKE_FD = 42;
+
+  SFE_MMC5983MA_Simulator &sim;
+
+  // Behaviour
+  bool openFails = false;
+  unsigned long failingRequest = 0; // An ioctl request which returns -1
+
+  // What the transport did
+  int openFds = 0;
+  uint32_t opens = 0;
+  uint32_t closes = 0;
+  uint32_t ioctls = 0;
+  uint32_t wrongFds = 0;
+  uint8_t spiMode = 0xFF;
+  uint8_t spiBits = 0;
+  uint32_t spiSpeed = 0;
+  uint16_t i2cAddress = 0;
+
+  FakeFile(SFE_MMC5983MA_Simulator &simulator) : sim(simulator) {}
+
+  int openDevice(const char *path) override
+  {
+    (void)path;
+    if (openFails)
+      return -1;
+    opens++;
+    openFds++;
+    return FAKE_FD;
+  }
+
+  int closeDevice(int fd) override
+  {
+    if (fd != FAKE_FD)
+      wrongFds++;
+    closes++;
+    openFds--;
+    return 0;
+  }
+
+  int ioctlDevice(int fd, unsigned long request, void *argument) override
+  {
+    ioctls++;
+    if (fd != FAKE_FD)
+    {
+      wrongFds++;
+      return -1;
+    }
+    if ((failingRequest != 0) && (request == failingRequest))
+      return -1;
+
+    if (request == SPI_IOC_WR_MODE)
+      spiMode = *(uint8_t *)argument;
+    else if (request == SPI_IOC_WR_BITS_PER_WORD)
+      spiBits = *(uint8_t *)argument;
+    else if (request == SPI_IOC_WR_MAX_SPEED_HZ)
+      spiSpeed = *(uint32_t *)argument;
+    else if (request == SPI_IOC_MESSAGE(1))
+    {
+      // Full duplex: the first byte out is the register address, with bit 7 set to read
+      struct spi_ioc_transfer *message = (struct spi_ioc_transfer *)argument;
+      uint8_t *txBuffer = (uint8_t *)(uintptr_t)message->tx_buf;
+      uint8_t *rxBuffer = (uint8_t *)(uintptr_t)message->rx_buf;
+      if (txBuffer[0] & 0x80)
+        sim.readMultipleBytes(txBuffer[0] & 0x7F, rxBuffer + 1, message->len - 1);
+      else
+        sim.writeMultipleBytes(txBuffer[0], txBuffer + 1, message->len - 1);
+      return message->len;
+    }
+    else if (request == I2C_RDWR)
+    {
+      // A read is a register address write and a read message; a write is a single message
+      struct i2c_rdwr_ioctl_data *transaction = (struct i2c_rdwr_ioctl_data *)argument;
+      i2cAddress = transaction->msgs[0].addr;
+      if (transaction->nmsgs == 2)
+        sim.readMultipleBytes(transaction->msgs[0].buf[0], transaction->msgs[1].buf, transaction->msgs[1].len);
+      else
+        sim.writeMultipleBytes(transaction->msgs[0].buf[0], transaction->msgs[0].buf + 1, transaction->msgs[0].len - 1);
+      return transaction->nmsgs;
+    }
+    else
+      return -1;
+
+    return 0;
+  }
+};
+
+static void testSPI()
+{
+    SFE_MMC5983MA_Simulator sim;
+    FakeFile file(sim);
+    sim.setField(100, -200, 300);
+
+    {
+        SFE_MMC5983MA_LinuxSPI spi(&file);
+        CHECK(spi.begin("/dev/spidev0.0", 1000000, 0));
+        CHECK(file.spiMode == 0);
+        CHECK(file.spiBits == 8);
+        CHECK(file.spiSpeed == 1000000);
+
+        SFE_MMC5983MA mag;
+        CHECK(mag.begin(spi));
+
+        // The bus time base is the simulator's here: wait on it, not on the clock
+        uint32_t x = 0, y = 0, z = 0;
+        CHECK(mag.startMeasurement());
+        sim.waitMicros(mag.getMeasurementTime());
+        CHECK(mag.readFieldsXYZ(&x, &y, &z));
+        CHECK((int32_t)x - MID_SCALE == 100);
+        CHECK((int32_t)y - MID_SCALE == -200);
+        CHECK((int32_t)z - MID_SCALE == 300);
+
+        // Reopening closes the previous descriptor first
+        CHECK(spi.begin("/dev/spidev0.1"));
+        CHECK(file.openFds == 1);
+    }
+
+    // The destructor closes the device
+    CHECK(file.openFds == 0);
+    CHECK(file.closes == file.opens);
+    CHECK(file.wrongFds == 0);
+}
+
+static void testSPIErrors()
+{
+    SFE_MMC5983MA_Simulator sim;
+    FakeFile file(sim);
+    SFE_MMC5983MA_LinuxSPI spi(&file);
+
+    file.openFails = true;
+    CHECK(!spi.begin("/dev/spidev0.0"));
+    CHECK(file.openFds == 0);
+
+    // A failed configuration closes the device again
+    file.openFails = false;
+    file.failingRequest = SPI_IOC_WR_MAX_SPEED_HZ;
+    CHECK(!spi.begin("/dev/spidev0.0"));
+    CHECK(file.openFds == 0);
+
+    // A failed transfer fails the read
+    file.failingRequest = SPI_IOC_MESSAGE(1);
+    CHECK(spi.begin("/dev/spidev0.0"));
+    uint8_t value = 0;
+    CHECK(!spi.readMultipleBytes(PROD_ID_REG, &value, 1));
+    CHECK(!spi.isConnected());
+
+    // After end() the closed descriptor is not used again: the ioctl gets -1 and the read fails
+    spi.end();
+    file.failingRequest = 0;
+    CHECK(!spi.readMultipleBytes(PROD_ID_REG, &value, 1));
+    CHECK(file.wrongFds == 1);
+}
+
+static void testI2C()
+{
+    SFE_MMC5983MA_Simulator sim;
+    FakeFile file(sim);
+    sim.setField(-1000, 2000, -3000);
+
+    SFE_MMC5983MA_LinuxI2C i2c(&file);
+    CHECK(i2c.begin("/dev/i2c-1"));
+
+    SFE_MMC5983MA mag;
+    CHECK(mag.begin(i2c));
+    CHECK(file.i2cAddress == I2C_ADDR);
+
+    uint32_t x = 0, y = 0, z = 0;
+    CHECK(mag.startMeasurement());
+    sim.waitMicros(mag.getMeasurementTime());
+    CHECK(mag.readFieldsXYZ(&x, &y, &z));
+    CHECK((int32_t)x - MID_SCALE == -1000);
+    CHECK((int32_t)y - MID_SCALE == 2000);
+    CHECK((int32_t)z - MID_SCALE == -3000);
+
+    // Writes reach the device
+    CHECK(mag.setFilterBandwidth(800));
+    CHECK(sim.peekRegister(INT_CTRL_1_REG) == (BW0 | BW1));
+
+    file.failingRequest = I2C_RDWR;
+    CHECK(!i2c.isConnected());
+    uint8_t value = BW0;
+    CHECK(!i2c.writeMultipleBytes(INT_CTRL_1_REG, &value, 1));
+
+    i2c.end();
+    CHECK(file.openFds == 0);
+    CHECK(file.wrongFds == 0);
+}
+
+static void testRealFile()
+{
+    // The default backend makes the real system calls
+    SFE_MMC5983MA_LinuxFile file;
+
+    int fd = file.openDevice("/dev/null");
+    CHECK(fd >= 0);
+    uint8_t mode = 0;
+    CHECK(file.ioctlDevice(fd, SPI_IOC_WR_MODE, &mode) == -1);
+    CHECK(file.closeDevice(fd) == 0);
+
+    CHECK(file.openDevice("/nonexistent/spidev") == -1);
+
+    SFE_MMC5983MA_LinuxSPI spi;
+    CHECK(!spi.begin("/dev/null")); // Not an SPI device
+}
+
+static volatile sig_atomic_t signals = 0;
+
+static void onSignal(int signalNumber)
+{
+    (void)signalNumber;
+    signals = signals + 1;
+}
+
+static void testWait()
+{
+    SFE_MMC5983MA_LinuxI2C bus;
+
+    // A signal part way through the sleep must not cut it short
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigaction(SIGALRM, &action, nullptr);
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    timer.it_value.tv_usec = 10000;
+    setitimer(ITIMER_REAL, &timer, nullptr);
+
+    uint32_t start = bus.getMicros();
+    bus.waitMicros(50000);
+    uint32_t elapsed = bus.getMicros() - start;
+
+    CHECK(signals == 1);
+    CHECK(elapsed >= 50000);
+
+    signal(SIGALRM, SIG_DFL);
+}
+
+int main()
+{
+    testSPI();
+    testSPIErrors();
+    testI2C();
+    testRealFile();
+    testWait();
+    return testResult();
+}
@@ -0,0 +1,187 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file tests SFE_MMC5983MA_RateMonitor with frame times generated on the host, running across
+  the micros() wrap: the measured rate of a slow sensor clock, DATA_RATE_TOO_LOW on dropped frames,
+  DATA_STALLED once per stall, the interval jitter and the latency histogram. Then a reader thread
+  checks that getReport() never returns a torn snapshot while frames keep arriving.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_RateMonitor.h"
+#include "SparkFun_MMC5983MA_Simulator.h"
+#include "test.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Ten seconds before micros() wraps
+static const uint32_t START = 0xFFFFFFFFUL - 10000000UL;
+
+static uint32_t rateErrors = 0;
+static uint32_t stallErrors = 0;
+
+static void errorCallback(SF_MMC5983MA_ERROR errorCode)
+{
+    if (errorCode == SF_MMC5983MA_ERROR::DATA_RATE_TOO_LOW)
+        rateErrors++;
+    else if (errorCode == SF_MMC5983MA_ERROR::DATA_STALLED)
+        stallErrors++;
+}
+
+static uint32_t randomState = 1;
+
+// Uniform in [0, range)
+static uint32_t randomBelow(uint32_t range)
+{
+    randomState = (randomState * 1664525UL) + 1013904223UL;
+    return (randomState >> 8) % range;
+}
+
+static void testRate()
+{
+    SFE_MMC5983MA_Simulator sim;
+    SFE_MMC5983MA mag;
+    SFE_MMC5983MA_RateMonitor monitor;
+    SFE_MMC5983MA_RateReport report;
+    SFE_MMC5983MA_Frame frame = {};
+
+    CHECK(mag.begin(sim));
+    mag.setErrorCallback(errorCallback);
+    monitor.begin(mag);
+    monitor.setExpectedRate(1000);
+
+    // A sensor clock 0.37% slow: 1003.7us per frame, for five windows
+    rateErrors = 0;
+    for (uint32_t i = 0; i <= 5000; i++)
+        monitor.onFrame(frame, START + (uint32_t)(i * 1003.7));
+    monitor.getReport(&report);
+    printf("  1003.7us period: %u.%03uHz\n", report.measuredRate / 1000, report.measuredRate % 1000);
+    CHECK(report.configuredRate == 1000000);
+    CHECK(report.measuredRate >= 996000 && report.measuredRate <= 996500);
+    CHECK(report.frames == 5001);
+    CHECK(report.windows == 5);
+    CHECK(report.lowRateWindows == 0);
+    CHECK(rateErrors == 0);
+
+    // One frame in five dropped: every window is below 90%
+    monitor.reset();
+    uint32_t now = START;
+    for (uint32_t i = 0; i <= 5000; i++, now += 1000)
+    {
+        if (randomBelow(5) != 0)
+            monitor.onFrame(frame, now);
+    }
+    monitor.getReport(&report);
+    printf("  20%% dropped: %u.%03uHz\n", report.measuredRate / 1000, report.measuredRate % 1000);
+    CHECK(report.measuredRate >= 770000 && report.measuredRate <= 830000);
+    CHECK(report.windows >= 4);
+    CHECK(report.lowRateWindows == report.windows);
+    CHECK(rateErrors == report.lowRateWindows);
+
+    // Stall for three seconds, checking every 100ms: raised once
+    stallErrors = 0;
+    uint32_t last = now;
+    CHECK(monitor.check(now));
+    for (uint32_t t = 100000; t <= 3000000; t += 100000)
+        monitor.check(last + t);
+    CHECK(!monitor.check(last + 3000000));
+    CHECK(stallErrors == 1);
+
+    // Frames again: the stall is over, and the next one raises again
+    monitor.onFrame(frame, last + 3000000);
+    CHECK(monitor.check(last + 3000000));
+    CHECK(!monitor.check(last + 4000000));
+    CHECK(stallErrors == 2);
+    monitor.getReport(&report);
+    CHECK(report.stalls == 2);
+}
+
+static void testJitterAndLatency()
+{
+    SFE_MMC5983MA_RateMonitor monitor;
+    SFE_MMC5983MA_RateReport report;
+    SFE_MMC5983MA_Frame frame = {};
+
+    monitor.setExpectedRate(1000);
+
+    // Frames on a 1000us grid, each read 0-299us late: the intervals have a standard deviation of
+    // sqrt(2) * 300 / sqrt(12) = 122.5us. Each edge is marked 100us before the read.
+    for (uint32_t i = 0; i <= 10000; i++)
+    {
+        uint32_t read = START + (i * 1000) + randomBelow(300);
+        monitor.markInterrupt(read - 100);
+        monitor.onFrame(frame, read);
+    }
+    monitor.getReport(&report);
+    printf("  jitter: %uus (122.5us expected)\n", report.jitter);
+    CHECK(report.jitter >= 115 && report.jitter <= 130);
+    CHECK(report.minimumInterval >= 701 && report.maximumInterval <= 1299);
+
+    // 100us falls in the 64-127us bin
+    CHECK(report.latencyHistogram[6] == 10001);
+    CHECK(report.maximumLatency == 100);
+    CHECK(SFE_MMC5983MA_RateMonitor::getLatencyPercentile(report, 99) == 127);
+
+    // Without a rate there are no rate checks
+    monitor.setExpectedRate(0);
+    CHECK(monitor.check(0));
+    CHECK(monitor.check(50000000));
+}
+
+static void testStress()
+{
+    SFE_MMC5983MA_RateMonitor monitor;
+    std::atomic<bool> stop(false);
+    uint32_t snapshots = 0;
+    uint32_t torn = 0;
+
+    monitor.setExpectedRate(1000);
+    monitor.setWindow(1000);
+
+    // Every frame has an edge, so the histogram always adds up to the frames
+    std::thread publisher([&]() {
+        SFE_MMC5983MA_Frame frame = {};
+        for (uint32_t i = 0; !stop; i++)
+        {
+            monitor.markInterrupt(i * 1000);
+            monitor.onFrame(frame, (i * 1000) + (i % 3000));
+        }
+    });
+
+    SFE_MMC5983MA_RateReport report;
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        monitor.getReport(&report);
+        snapshots++;
+
+        uint32_t histogramTotal = 0;
+        for (uint8_t i = 0; i < SFE_MMC5983MA_LATENCY_BINS; i++)
+            histogramTotal += report.latencyHistogram[i];
+        if ((histogramTotal != report.frames) || (report.windows > report.frames))
+            torn++;
+    }
+
+    stop = true;
+    publisher.join();
+
+    printf("  %u snapshots\n", snapshots);
+    CHECK(snapshots > 0);
+    CHECK(torn == 0);
+}
+
+int main()
+{
+    testRate();
+    testJitterAndLatency();
+    testStress();
+    return testResult();
+}
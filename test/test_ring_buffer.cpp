@@ -0,0 +1,124 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file tests SFE_MMC5983MA_RingBuffer: ordering, overruns and index wrap on one thread,
+  then a producer and a consumer thread checking that every item arrives once, intact and in order.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_RingBuffer.h"
+#include "test.h"
+
+#include <thread>
+
+struct Item
+{
+    uint32_t sequence;
+    uint32_t check;
+    uint32_t inverse;
+};
+
+static Item makeItem(uint32_t sequence)
+{
+    Item item = {sequence, (uint32_t)(sequence * 2654435761UL), ~sequence};
+    return item;
+}
+
+static bool isItem(const Item &item, uint32_t sequence)
+{
+    return (item.sequence == sequence) && (item.check == (uint32_t)(sequence * 2654435761UL)) && (item.inverse == ~sequence);
+}
+
+static void testSingleThread()
+{
+    SFE_MMC5983MA_RingBuffer<Item, 8> ring;
+    Item buffer[8];
+
+    CHECK(ring.capacity() == 8);
+    CHECK(ring.available() == 0);
+    CHECK(ring.pop(buffer, 8) == 0);
+
+    // Fill it, then one more is an overrun
+    for (uint32_t i = 0; i < 8; i++)
+        CHECK(ring.push(makeItem(i)));
+    CHECK(!ring.push(makeItem(8)));
+    CHECK(ring.getOverruns() == 1);
+    CHECK(ring.getHighWaterMark() == 8);
+    CHECK(ring.available() == 8);
+
+    // Partial pop, in order
+    CHECK(ring.pop(buffer, 3) == 3);
+    for (uint32_t i = 0; i < 3; i++)
+        CHECK(isItem(buffer[i], i));
+
+    // Refill across the end of the storage and drain it
+    for (uint32_t i = 8; i < 11; i++)
+        CHECK(ring.push(makeItem(i)));
+    CHECK(ring.pop(buffer, 8) == 8);
+    for (uint32_t i = 0; i < 8; i++)
+        CHECK(isItem(buffer[i], i + 3));
+    CHECK(ring.available() == 0);
+
+    // Run the free-running indexes through their whole range, and past it
+    uint32_t next = 11;
+    for (uint32_t round = 0; round < 70000; round++)
+    {
+        CHECK(ring.push(makeItem(next)));
+        CHECK(ring.pop(buffer, 8) == 1);
+        CHECK(isItem(buffer[0], next));
+        next++;
+    }
+    CHECK(ring.getOverruns() == 1);
+}
+
+static void testProducerConsumer()
+{
+    static SFE_MMC5983MA_RingBuffer<Item, 64> ring;
+    const uint32_t ITEMS = 500000;
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < ITEMS; i++)
+        {
+            // A full buffer is not an error here: wait for the consumer
+            while (!ring.push(makeItem(i)))
+                std::this_thread::yield();
+        }
+    });
+
+    uint32_t next = 0;
+    uint32_t bad = 0;
+    Item buffer[16];
+    while (next < ITEMS)
+    {
+        sfe_mmc5983ma_ring_index_t count = ring.pop(buffer, 16);
+        if (count == 0)
+            std::this_thread::yield();
+
+        for (sfe_mmc5983ma_ring_index_t i = 0; i < count; i++)
+        {
+            if (!isItem(buffer[i], next))
+                bad++;
+            next++;
+        }
+    }
+
+    producer.join();
+
+    CHECK(bad == 0);
+    CHECK(next == ITEMS);
+    CHECK(ring.available() == 0);
+    CHECK(ring.getHighWaterMark() <= 64);
+}
+
+int main()
+{
+    testSingleThread();
+    testProducerConsumer();
+    return testResult();
+}
@@ -0,0 +1,174 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file tests SFE_MMC5983MA_SampleClock against a simulated sensor clock: 1000Hz nominal but
+  1003.7us true period, 0-30us uniform interrupt latency, and 1% of edges followed by a gap of
+  1-3 lost samples, starting just before micros() wraps. It checks that the clock locks to the true
+  period, that the sample index and the lost sample and gap counts are exact, and that the modelled
+  timestamps have less jitter than the raw edges.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_SampleClock.h"
+#include "test.h"
+
+#include <math.h>
+
+static uint32_t randomState = 1;
+
+// Uniform in [0, range)
+static uint32_t randomBelow(uint32_t range)
+{
+    randomState = (randomState * 1664525UL) + 1013904223UL;
+    return (randomState >> 8) % range;
+}
+
+// Records the timestamps the clock passes on
+class TimestampSink : public SFE_MMC5983MA_FrameSink
+{
+public:
+  uint32_t frames = 0;
+  uint32_t lastTimestamp = 0;
+
+  void onFrame(const SFE_MMC5983MA_Frame &frame, uint32_t timestamp) override
+  {
+    (void)frame;
+    frames++;
+    lastTimestamp = timestamp;
+  }
+};
+
+static void testLock()
+{
+    SFE_MMC5983MA_SampleClock clock;
+    clock.setNominalRate(1000);
+    CHECK(clock.getPeriod() == 1000 * 256);
+
+    const uint32_t SAMPLES = 200000;
+    const uint32_t SETTLE = 5000;
+    const double TRUE_PERIOD = 1003.7;
+    const double MEAN_LATENCY = 15.0;
+
+    // Ten seconds before micros() wraps
+    const double start = 4294967296.0 - 10000000.0;
+
+    uint32_t trueIndex = 0;
+    uint32_t trueMissed = 0;
+    uint32_t trueGaps = 0;
+    uint32_t wrongIndex = 0;
+
+    double modelSquares = 0, modelWorst = 0;
+    double edgeSquares = 0, edgeWorst = 0;
+    uint32_t measured = 0;
+
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        if ((i > 0) && (randomBelow(100) == 0))
+        {
+            uint32_t lost = 1 + randomBelow(3);
+            trueIndex += lost;
+            trueMissed += lost;
+            trueGaps++;
+        }
+
+        double sampleTime = start + (trueIndex * TRUE_PERIOD);
+        uint32_t latency = randomBelow(31);
+        uint32_t edge = (uint32_t)(uint64_t)(sampleTime + latency);
+        uint32_t timestamp = clock.update(edge);
+
+        if (clock.getSampleIndex() != trueIndex)
+            wrongIndex++;
+
+        // Compare both with the sample time plus the mean latency, which the model cannot tell apart
+        if (i >= SETTLE)
+        {
+            double expected = sampleTime + MEAN_LATENCY;
+            double modelError = fabs((double)(int32_t)(timestamp - (uint32_t)(uint64_t)expected));
+            double edgeError = fabs((double)(int32_t)(edge - (uint32_t)(uint64_t)expected));
+            modelSquares += modelError * modelError;
+            edgeSquares += edgeError * edgeError;
+            if (modelError > modelWorst)
+                modelWorst = modelError;
+            if (edgeError > edgeWorst)
+                edgeWorst = edgeError;
+            measured++;
+        }
+
+        trueIndex++;
+    }
+
+    double modelRms = sqrt(modelSquares / measured);
+    double edgeRms = sqrt(edgeSquares / measured);
+    double periodError = fabs((clock.getPeriod() / 256.0) - TRUE_PERIOD);
+
+    printf("  timestamp error: %.1fus RMS, %.0fus worst; raw edges %.1fus RMS, %.0fus worst; period error %.3fus\n",
+           modelRms, modelWorst, edgeRms, edgeWorst, periodError);
+
+    CHECK(wrongIndex == 0);
+    CHECK(clock.getMissedSamples() == trueMissed);
+    CHECK(clock.getGapCount() == trueGaps);
+    CHECK(periodError < 0.1);
+    CHECK(modelRms < edgeRms / 2);
+    CHECK(modelWorst < edgeWorst);
+    CHECK(clock.getMeasuredRate() > 996000 && clock.getMeasuredRate() < 997000);
+}
+
+static void testRestart()
+{
+    SFE_MMC5983MA_SampleClock clock;
+    TimestampSink sink;
+    SFE_MMC5983MA_Frame frame = {};
+
+    // No model before setNominalRate(): times pass through
+    CHECK(clock.update(12345) == 12345);
+
+    clock.setDownstream(&sink);
+    clock.setNominalRate(100);
+    uint32_t now = 1000;
+    for (uint32_t i = 0; i < 20; i++, now += 10000)
+        clock.onFrame(frame, now);
+    CHECK(sink.frames == 20);
+    CHECK(sink.lastTimestamp == now - 10000);
+    CHECK(clock.getSampleIndex() == 19);
+
+    // The ISR's edge time is used in place of the read time
+    clock.markInterrupt(now);
+    clock.onFrame(frame, now + 400);
+    CHECK(sink.lastTimestamp == now);
+    CHECK(clock.getLastError() == 0);
+    now += 10000;
+
+    // Three lost samples
+    now += 30000;
+    clock.onFrame(frame, now);
+    CHECK(clock.getSampleIndex() == 24);
+    CHECK(clock.getLastGap() == 3);
+    CHECK(clock.getMissedSamples() == 3);
+    CHECK(clock.getGapCount() == 1);
+    now += 10000;
+
+    // An edge more than half a period early restarts the grid there
+    now -= 6000;
+    clock.onFrame(frame, now);
+    CHECK(sink.lastTimestamp == now);
+    CHECK(clock.getSampleIndex() == 25);
+    CHECK(clock.getLastGap() == 0);
+
+    clock.reset();
+    clock.onFrame(frame, 5);
+    CHECK(clock.getSampleIndex() == 0);
+    CHECK(clock.getMissedSamples() == 0);
+}
+
+int main()
+{
+    testLock();
+    testRestart();
+    return testResult();
+}
@@ -0,0 +1,367 @@
+/*
+  This is a library written for the MMC5983MA High Performance Magnetometer.
+  SparkFun sells these at its website:
+  https://www.sparkfun.com/products/19034
+
+  Do you like this library? Help support open source hardware. Buy a board!
+
+  This file holds deterministic regression tests of the driver against SFE_MMC5983MA_Simulator:
+  measurements, temperature (including interleaved conversions), soft reset, continuous mode,
+  profiles and the non-blocking front end. Simulated time only moves when the driver waits or
+  uses the bus, so every run is identical.
+
+  SparkFun code, firmware, and software is released under the MIT License(http://opensource.org/licenses/MIT).
+  See LICENSE.md for more information.
+*/
+
+#include "SparkFun_MMC5983MA_Arduino_Library.h"
+#include "SparkFun_MMC5983MA_Async.h"
+#include "SparkFun_MMC5983MA_Simulator.h"
+#include "test.h"
+
+static const int32_t MID_SCALE = 131072;
+
+// Passes everything through to the simulator, and checks the commands written on the way
+class CommandProbe : public SFE_MMC5983MA_Bus
+{
+public:
+  SFE_MMC5983MA_Simulator &sim;
+
+  // Writes which set TM_M and TM_T together: the datasheet does not allow it
+  uint32_t combinedConversions = 0;
+
+  // While set, STATUS_REG reads report OTP_READ_DONE, as if left over from before a soft reset
+  uint64_t staleOTPUntil = 0;
+  bool staleOTP = false;
+
+  CommandProbe(SFE_MMC5983MA_Simulator &simulator) : sim(simulator) {}
+
+  bool readMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) override
+  {
+    bool success = sim.readMultipleBytes(registerAddress, buffer, packetLength);
+    if (staleOTP && (registerAddress == STATUS_REG) && (sim.getTime() < staleOTPUntil))
+      buffer[0] |= OTP_READ_DONE;
+    return success;
+  }
+
+  bool writeMultipleBytes(const uint8_t registerAddress, uint8_t *const buffer, const uint8_t packetLength) override
+  {
+    if ((registerAddress == INT_CTRL_0_REG) && ((buffer[0] & (TM_M | TM_T)) == (TM_M | TM_T)))
+      combinedConversions++;
+    if ((registerAddress == INT_CTRL_1_REG) && (buffer[0] & SW_RST))
+      staleOTPUntil = sim.getTime() + 300;
+    return sim.writeMultipleBytes(registerAddress, buffer, packetLength);
+  }
+
+  uint32_t getMicros() override
+  {
+    return sim.getMicros();
+  }
+
+  void waitMicros(uint32_t duration) override
+  {
+    sim.waitMicros(duration);
+  }
+};
+
+static void testProtocolErrors()
+{
+    SFE_MMC5983MA_Simulator sim;
+    uint8_t command = 0;
+
+    // One conversion after the other is fine
+    command = TM_M;
+    sim.writeMultipleBytes(INT_CTRL_0_REG, &command, 1);
+    sim.waitMicros(8000);
+    command = TM_T;
+    sim.writeMultipleBytes(INT_CTRL_0_REG, &command, 1);
+    sim.waitMicros(8000);
+    CHECK(sim.getProtocolErrorCount() == 0);
+
+    // Both in one write, TM_M while TM_T is running, and TM_T while TM_M is running
+    command = TM_M | TM_T;
+    sim.writeMultipleBytes(INT_CTRL_0_REG, &command, 1);
+    CHECK(sim.getProtocolErrorCount() == 1);
+    sim.waitMicros(8000);
+
+    command = TM_T;
+    sim.writeMultipleBytes(INT_CTRL_0_REG, &command, 1);
+    command = TM_M;
+    sim.writeMultipleBytes(INT_CTRL_0_REG, &command, 1);
+    CHECK(sim.getProtocolErrorCount() == 2);
+    sim.waitMicros(8000);
+
+    command = TM_M;
+    sim.writeMultipleBytes(INT_CTRL_0_REG, &command, 1);
+    command = TM_T;
+    sim.writeMultipleBytes(INT_CTRL_0_REG, &command, 1);
+    CHECK(sim.getProtocolErrorCount() == 3);
+}
+
+static void testMeasurement()
+{
+    SFE_MMC5983MA_Simulator sim;
+    SFE_MMC5983MA mag;
+    sim.setField(1000, -2000, 3000);
+
+    CHECK(mag.begin(sim));
+    CHECK(mag.isConnected());
+
+    static const uint16_t bandwidths[] = {100, 200, 400, 800};
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        CHECK(mag.setFilterBandwidth(bandwidths[i]));
+        CHECK(mag.getFilterBandwidth() == bandwidths[i]);
+
+        uint64_t start = sim.getTime();
+        uint32_t x = 0, y = 0, z = 0;
+        CHECK(mag.getMeasurementXYZ(&x, &y, &z));
+
+        CHECK((int32_t)x - MID_SCALE == 1000);
+        CHECK((int32_t)y - MID_SCALE == -2000);
+        CHECK((int32_t)z - MID_SCALE == 3000);
+
+        // Never returns before the conversion can have finished, nor long after
+        uint64_t elapsed = sim.getTime() - start;
+        CHECK(elapsed >= mag.getMeasurementTime());
+        CHECK(elapsed < mag.getMeasurementTime() + 1000);
+    }
+
+    // A frame carries the fields and the status, and reading it clears the done bit
+    SFE_MMC5983MA_Frame frame;
+    CHECK(mag.startMeasurement());
+    CHECK(mag.waitUntilMeasurementReady());
+    CHECK(mag.readFrame(&frame));
+    CHECK((int32_t)frame.x - MID_SCALE == 1000);
+    CHECK((frame.status & MEAS_M_DONE) != 0);
+    CHECK((sim.peekRegister(STATUS_REG) & MEAS_M_DONE) == 0);
+}
+
+static void testTemperature()
+{
+    SFE_MMC5983MA_Simulator sim;
+    CommandProbe probe(sim);
+    SFE_MMC5983MA mag;
+    sim.setTemperature(128);
+
+    CHECK(mag.begin(probe));
+
+    // At BW 100 the conversion takes 8ms: sleep through it, then poll the status once
+    uint8_t raw = 0;
+    uint64_t start = sim.getTime();
+    uint32_t transactions = sim.getTransactionCount();
+    CHECK(mag.getTemperatureRaw(&raw));
+    CHECK(raw == 128);
+    CHECK(sim.getTime() - start >= mag.getMeasurementTime());
+    CHECK(sim.getTime() - start < mag.getMeasurementTime() + 1000);
+    CHECK(sim.getTransactionCount() - transactions == 3); // TM_T, STATUS_REG, T_OUT_REG
+    CHECK(mag.clearMeasDoneInterrupt(MEAS_T_DONE));
+
+    CHECK(mag.setFilterBandwidth(800));
+
+    CHECK(SFE_MMC5983MA::convertTemperature(0) == -7500);
+    CHECK(SFE_MMC5983MA::convertTemperature(128) == 2539);
+    CHECK(SFE_MMC5983MA::convertTemperature(255) == 12500);
+
+    CHECK(mag.getTemperatureRaw(&raw));
+    CHECK(raw == 128);
+    CHECK(mag.clearMeasDoneInterrupt(MEAS_T_DONE));
+
+    // Interleaved: a temperature conversion after every 10th measurement. Driven like Example17,
+    // with the next measurement started as soon as the frame is read: the two conversions must
+    // never run at the same time.
+    mag.setTemperatureInterval(10);
+
+    uint32_t before = sim.getTemperatureMeasurementCount();
+    uint32_t temperatures = 0;
+    for (uint8_t i = 0; i < 100; i++)
+    {
+        SFE_MMC5983MA_Frame frame;
+        CHECK(mag.startMeasurement());
+        CHECK(mag.waitUntilMeasurementReady());
+        CHECK(mag.readFrame(&frame));
+
+        int16_t centiDegrees = 0;
+        if (mag.getLatestTemperature(&centiDegrees))
+        {
+            CHECK(centiDegrees == 2539);
+            temperatures++;
+        }
+    }
+
+    CHECK(probe.combinedConversions == 0);
+    CHECK(sim.getProtocolErrorCount() == 0);
+    CHECK(temperatures == 9);
+
+    // The last conversion was started by the last frame read, and is still running
+    CHECK(sim.getTemperatureMeasurementCount() - before == 9);
+    sim.waitMicros(mag.getMeasurementTime());
+    CHECK(sim.getTemperatureMeasurementCount() - before == 10);
+}
+
+static void testSoftReset()
+{
+    SFE_MMC5983MA_Simulator sim;
+    CommandProbe probe(sim);
+    SFE_MMC5983MA mag;
+
+    CHECK(mag.begin(probe));
+    CHECK(mag.setFilterBandwidth(400));
+    CHECK(mag.enableAutomaticSetReset());
+
+    // A device which still shows OTP_READ_DONE from before the reset must not end the wait early
+    for (uint8_t stale = 0; stale < 2; stale++)
+    {
+        probe.staleOTP = (stale != 0);
+
+        uint64_t start = sim.getTime();
+        CHECK(mag.softReset());
+        CHECK(sim.getTime() - start >= 10000);
+        CHECK(sim.getTime() - start < 15000);
+        CHECK((sim.peekRegister(STATUS_REG) & OTP_READ_DONE) != 0);
+
+        // The control registers and their shadows are back to zero
+        CHECK(mag.getFilterBandwidth() == 100);
+        CHECK(!mag.isAutomaticSetResetEnabled());
+        CHECK(sim.peekRegister(INT_CTRL_1_REG) == 0);
+    }
+}
+
+static void testContinuousMode()
+{
+    SFE_MMC5983MA_Simulator sim;
+    SFE_MMC5983MA mag;
+    sim.setField(-500, 250, 125);
+
+    CHECK(mag.begin(sim));
+    CHECK(mag.setFilterBandwidth(800));
+    CHECK(mag.setContinuousModeFrequency(100));
+    CHECK(mag.enableInterrupt());
+    CHECK(mag.enableContinuousMode());
+
+    // One second of frames, read as the INT pin asserts
+    uint64_t end = sim.getTime() + 1000000;
+    uint32_t frames = 0;
+    while (sim.getTime() < end)
+    {
+        sim.waitMicros(100);
+        if (sim.isInterruptAsserted())
+        {
+            SFE_MMC5983MA_Frame frame;
+            CHECK(mag.readFrame(&frame));
+            CHECK((int32_t)frame.x - MID_SCALE == -500);
+            CHECK(!sim.isInterruptAsserted());
+            frames++;
+        }
+    }
+
+    CHECK((frames >= 99) && (frames <= 101));
+
+    CHECK(mag.disableContinuousMode());
+    uint32_t measurements = sim.getMagneticMeasurementCount();
+    sim.waitMicros(100000);
+    CHECK(sim.getMagneticMeasurementCount() == measurements);
+}
+
+static void testProfiles()
+{
+    SFE_MMC5983MA_Simulator sim;
+    SFE_MMC5983MA mag;
+
+    CHECK(mag.begin(sim));
+
+    constexpr SFE_MMC5983MA_Profile highRate = SFE_MMC5983MA_Profile()
+                                                   .withFilterBandwidth(800)
+                                                   .withContinuousModeFrequency(1000)
+                                                   .withAutomaticSetReset(true);
+    static_assert(highRate.isValid(), "highRate profile is invalid");
+
+    CHECK(mag.applyProfile(highRate));
+    CHECK(mag.getFilterBandwidth() == 800);
+    CHECK(mag.getContinuousModeFrequency() == 1000);
+    CHECK(mag.isAutomaticSetResetEnabled());
+    CHECK(sim.peekRegister(INT_CTRL_1_REG) == highRate.getRegister(1));
+    CHECK(sim.peekRegister(INT_CTRL_2_REG) == highRate.getRegister(2));
+
+    // Rejected without touching the device
+    uint32_t transactions = sim.getTransactionCount();
+    CHECK(!mag.applyProfile(highRate.withFilterBandwidth(400)));
+    CHECK(sim.getTransactionCount() == transactions);
+    CHECK(mag.getFilterBandwidth() == 800);
+}
+
+static void testAsync()
+{
+    SFE_MMC5983MA_Simulator sim;
+    CommandProbe probe(sim);
+    SFE_MMC5983MA mag;
+    SFE_MMC5983MA_Async async(mag);
+    sim.setField(4000, 5000, -6000);
+    sim.setTemperature(200);
+
+    CHECK(mag.begin(probe));
+    probe.staleOTP = true;
+
+    // Each step makes at most one bus transaction per poll
+    uint32_t worstTransactions = 0;
+    uint64_t start = 0;
+    SFE_MMC5983MA_AsyncStatus status = SFE_MMC5983MA_AsyncStatus::PENDING;
+    auto run = [&]() {
+        start = sim.getTime();
+        do
+        {
+            uint32_t transactions = sim.getTransactionCount();
+            status = async.poll(sim.getMicros());
+            if (sim.getTransactionCount() - transactions > worstTransactions)
+                worstTransactions = sim.getTransactionCount() - transactions;
+            sim.waitMicros(10);
+        } while (status == SFE_MMC5983MA_AsyncStatus::PENDING);
+    };
+
+    CHECK(async.startSoftReset());
+    CHECK(!async.startMeasurement()); // Busy
+    run();
+    CHECK(status == SFE_MMC5983MA_AsyncStatus::DONE);
+    CHECK(sim.getTime() - start >= 10000);
+
+    CHECK(async.startConfigure(SFE_MMC5983MA_Profile().withFilterBandwidth(800)));
+    run();
+    CHECK(status == SFE_MMC5983MA_AsyncStatus::DONE);
+    CHECK(mag.getFilterBandwidth() == 800);
+
+    CHECK(async.startSetOperation());
+    run();
+    CHECK(status == SFE_MMC5983MA_AsyncStatus::DONE);
+
+    CHECK(async.startMeasurement());
+    run();
+    CHECK(status == SFE_MMC5983MA_AsyncStatus::DONE);
+
+    uint32_t x = 0, y = 0, z = 0;
+    async.getFields(&x, &y, &z);
+    uint32_t blockingX = 0, blockingY = 0, blockingZ = 0;
+    CHECK(mag.getMeasurementXYZ(&blockingX, &blockingY, &blockingZ));
+    CHECK((x == blockingX) && (y == blockingY) && (z == blockingZ));
+    CHECK((int32_t)x - MID_SCALE == 4000);
+
+    CHECK(async.startTemperatureMeasurement());
+    run();
+    CHECK(status == SFE_MMC5983MA_AsyncStatus::DONE);
+    CHECK(async.getTemperature() == SFE_MMC5983MA::convertTemperature(200));
+
+    CHECK(worstTransactions == 1);
+    CHECK(probe.combinedConversions == 0);
+    CHECK(sim.getProtocolErrorCount() == 0);
+}
+
+int main()
+{
+    testProtocolErrors();
+    testMeasurement();
+    testTemperature();
+    testSoftReset();
+    testContinuousMode();
+    testProfiles();
+    testAsync();
+    return testResult();
+}